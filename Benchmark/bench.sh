@@ -0,0 +1,194 @@
+#!/bin/sh
+#********************************************************************
+# bench.sh - cycle and size benchmark of the debounce libraries on a simulated ATmega328P
+#
+# Created: 19/10/2026
+# Author : agent
+#
+# The AVR modes (bench, telemetry, latency) have still never been run - there has been no avr-gcc or
+# simavr to hand where they were written, so none of the cycle counts they print have been seen and the
+# first run may need fixes.  Once one works, commit its output as Benchmark/baseline.csv.
+#
+#   sh Benchmark/bench.sh host        runs now, with only a host gcc - the same n button builds as the
+#                                     bench mode, built for the PC by bench_host.c and timed in ns.  Its
+#                                     output, run with BENCH_MS=20000, is Benchmark/baseline_host.csv.
+#                                     PC sizes and times only compare the builds with each other - see
+#                                     bench_host.c
+#
+# Needs avr-gcc/avr-size/avr-nm (the same toolchain Atmel Studio uses), simavr installed with
+# its headers, and a host gcc.  Run it from anywhere:  sh Benchmark/bench.sh
+#
+#   sh Benchmark/bench.sh telemetry   instead builds bench_telemetry.c and pipes its simulated UART
+#                                     through "Host tools/telemetry_decode", one line per event
+#   sh Benchmark/bench.sh latency     builds bench_latency.c, which times how long a competing
+#                                     interrupt waits, plain, with DEBOUNCE_NOBLOCK and with ISR_SLICE
+#
+# Each configuration is built with the same flags as the Release build in the .cproj files, run
+# under simavr for BENCH_MS milliseconds with the pin changes in stimulus.txt (or BENCH_STIMULUS),
+# and reported as CSV on stdout:
+#   config,n,flash,ram,function,calls,min,avg,max
+# flash/ram are bytes from avr-size, the cycle counts are per call (per interrupt for __vector_14).
+# The n button library is built four ways - as it is, with DEBOUNCE_INLINE=1, with link time
+# optimisation and with ISR_SLICE=4 - compare the flash and the bench_pass/__vector_14 cycles between
+# them.  The sliced build's max __vector_14 cycles should stay flat as the number of buttons goes up.
+#
+#********************************************************************
+
+set -e
+
+HERE=$(cd "$(dirname "$0")" && pwd)
+LIB="$HERE/../Library files"
+OUT="${BENCH_OUT:-$HERE/build}"
+BENCH_MS="${BENCH_MS:-2000}"
+STIM="${BENCH_STIMULUS:-$HERE/stimulus.txt}"
+AVRCC="${AVRCC:-avr-gcc}"
+CHECKS="$HERE/../Host tools/host_checks"
+HOSTFLAGS="-std=gnu11 -Os -Wall -DF_CPU=8000000UL"
+CFLAGS="-mmcu=atmega328p -DF_CPU=8000000UL -DNDEBUG -Os -funsigned-char -funsigned-bitfields -fpack-struct -fshort-enums -Wall"
+
+# TIMER0_COMPA_vect is __vector_14 on the ATmega328P
+# bench_pass is one pass over all the buttons in the benchmark main loop
+PROBES="__vector_14 bench_pass update_button is_button_pressed is_button_released is_button_down is_button_up"
+
+mkdir -p "$OUT"
+
+# the simulator, built only for the modes that run the AVR firmware
+build_simavr_bench()
+{
+	gcc -O2 -o "$OUT/simavr_bench" "$HERE/simavr_bench.c" \
+		$(pkg-config --cflags --libs simavr 2>/dev/null || echo "-lsimavr -lelf")
+}
+
+# pins the buttons are put on, in order - PD0/PD1 are left free for the UART
+PINS="D2 D3 D4 D5 D6 D7 B0 B1 B2 B3 B4 B5 C0 C1 C2 C3"
+
+# write a btn[] table for the first $1 pins - by address for the AVR, or with $2 set to host by the
+# register names, which are the stand in registers of the host checks on a PC
+button_table()
+{
+	echo "Buttons btn[n] = {"
+	i=0
+	for p in $PINS; do
+		[ $i -lt $1 ] || break
+		if [ "$2" = host ]; then
+			regs="&PIN${p%?}, &PORT${p%?}, &DDR${p%?}"
+		else
+			case $p in
+				B*) regs="(uint8_t*)0x23, (uint8_t*)0x25, (uint8_t*)0x24" ;;
+				C*) regs="(uint8_t*)0x26, (uint8_t*)0x28, (uint8_t*)0x27" ;;
+				D*) regs="(uint8_t*)0x29, (uint8_t*)0x2B, (uint8_t*)0x2A" ;;
+			esac
+		fi
+		echo "	{0x0${p#?}, $regs},"
+		i=$((i + 1))
+	done
+	echo "};"
+}
+
+# run an elf under simavr and print its results, prefixed with "config,n,flash,ram"
+run_elf()
+{
+	elf=$1; label=$2; count=$3
+	set -- $(avr-size "$elf" | awk 'NR == 2 { print $1 + $2, $2 + $3 }')
+	prefix="$label,$count,$1,$2"
+	args=""
+	for sym in $PROBES; do
+		addr=$(avr-nm "$elf" | awk -v s="$sym" '$3 == s { print $1 }')
+		[ -n "$addr" ] && args="$args $sym=0x$addr"
+	done
+	"$OUT/simavr_bench" "$elf" "$STIM" "$BENCH_MS" $args | sed "s/^/$prefix,/"
+}
+
+# n button v3 engine: bench_nbutton <label> <number of buttons> [extra compiler flags]
+bench_nbutton()
+{
+	label=$1; count=$2; shift 2
+	button_table "$count" > "$OUT/buttons_$label$count.h"
+	"$AVRCC" $CFLAGS "$@" -Dn=$count -DBUTTON_CONFIG="\"buttons_$label$count.h\"" \
+		-I"$OUT" -I"$LIB/n_button_V3" -o "$OUT/$label$count.elf" \
+		"$HERE/bench_nbutton.c" "$LIB/n_button_V3/n_button_debounce_v3.c"
+	run_elf "$OUT/$label$count.elf" "$label" "$count"
+}
+
+# one button v1 engine
+bench_onebutton()
+{
+	"$AVRCC" $CFLAGS -I"$LIB/One_button_V1" -o "$OUT/one_button_v1.elf" \
+		"$HERE/bench_onebutton.c" "$LIB/One_button_V1/one_button_debounce_v1.c"
+	run_elf "$OUT/one_button_v1.elf" one_button_v1 1
+}
+
+# UART telemetry end to end: firmware -> simulated UART -> host decoder
+telemetry()
+{
+	gcc -O2 -o "$OUT/telemetry_decode" "$HERE/../Host tools/telemetry_decode.c"
+	button_table 4 > "$OUT/buttons_telemetry.h"
+	"$AVRCC" $CFLAGS -DBUTTON_EVENTS=1 -Dn=4 -DBUTTON_CONFIG="\"buttons_telemetry.h\"" \
+		-I"$OUT" -I"$LIB/n_button_V3" -o "$OUT/telemetry.elf" "$HERE/bench_telemetry.c" \
+		"$LIB/n_button_V3/n_button_debounce_v3.c" "$LIB/n_button_V3/uart_telemetry.c"
+	"$OUT/simavr_bench" --uart - "$OUT/telemetry.elf" "$STIM" "$BENCH_MS" | "$OUT/telemetry_decode"
+}
+
+# competing interrupt latency: bench_latency <label> <number of buttons> [extra compiler flags]
+bench_latency()
+{
+	label=$1; count=$2; shift 2
+	button_table "$count" > "$OUT/buttons_$label$count.h"
+	"$AVRCC" $CFLAGS "$@" -Dn=$count -DBUTTON_CONFIG="\"buttons_$label$count.h\"" \
+		-I"$OUT" -I"$LIB/n_button_V3" -o "$OUT/$label$count.elf" \
+		"$HERE/bench_latency.c" "$LIB/n_button_V3/n_button_debounce_v3.c"
+	"$OUT/simavr_bench" --uart - "$OUT/$label$count.elf" "$STIM" "$BENCH_MS" | sed "s/^/$label,$count,/"
+}
+
+# n button v3 engine on the PC: bench_host <label> <number of buttons> [extra compiler flags]
+bench_host()
+{
+	label=$1; count=$2; shift 2
+	button_table "$count" host > "$OUT/buttons_host_$label$count.h"
+	gcc $HOSTFLAGS "$@" -Dn=$count -DBUTTON_CONFIG="\"buttons_host_$label$count.h\"" -isystem "$CHECKS/avr_stub" \
+		-I"$OUT" -I"$LIB/n_button_V3" -c -o "$OUT/host_$label$count.o" "$LIB/n_button_V3/n_button_debounce_v3.c"
+	gcc $HOSTFLAGS "$@" -Dn=$count -DBUTTON_CONFIG="\"buttons_host_$label$count.h\"" -isystem "$CHECKS/avr_stub" \
+		-I"$OUT" -I"$LIB/n_button_V3" -o "$OUT/host_$label$count" "$HERE/bench_host.c" "$OUT/host_$label$count.o"
+	set -- $(size "$OUT/host_$label$count.o" | awk 'NR == 2 { print $1 + $2, $2 + $3 }')
+	prefix="$label,$count,$1,$2"
+	"$OUT/host_$label$count" "$STIM" "$BENCH_MS" | sed "s/^/$prefix,/"
+}
+
+case "${1:-bench}" in
+	bench)
+		build_simavr_bench
+		echo "config,n,flash,ram,function,calls,min,avg,max"
+		for count in 1 4 8 16; do
+			bench_nbutton n_button_v3 $count
+			bench_nbutton n_button_v3_inline $count -DDEBOUNCE_INLINE=1
+			bench_nbutton n_button_v3_lto $count -flto
+			bench_nbutton n_button_v3_slice4 $count -DISR_SLICE=4
+		done
+		bench_onebutton
+		;;
+	telemetry)
+		build_simavr_bench
+		telemetry
+		;;
+	latency)
+		build_simavr_bench
+		echo "config,n,samples,min,avg,max,missed"
+		for count in 4 8 16; do
+			bench_latency n_button_v3 $count
+			bench_latency n_button_v3_noblock $count -DDEBOUNCE_NOBLOCK=1
+			bench_latency n_button_v3_slice4 $count -DISR_SLICE=4
+		done
+		;;
+	host)
+		echo "config,n,text,bss,function,calls,min_ns,median_ns,p99_ns"
+		for count in 1 4 8 16; do
+			bench_host n_button_v3 $count
+			bench_host n_button_v3_inline $count -DDEBOUNCE_INLINE=1
+			bench_host n_button_v3_slice4 $count -DISR_SLICE=4
+		done
+		;;
+	*)
+		echo "usage: $0 [bench|telemetry|latency|host]" >&2
+		exit 1
+		;;
+esac
@@ -0,0 +1,207 @@
+/*********************************************************************
+ * bench_host.c - the n button v3 benchmark built for the PC, for a baseline that can be run anywhere
+ *
+ * Created: 19/10/2026
+ * Author : agent
+ *
+ * Usage: bench_host stimulus.txt run_ms
+ *
+ * The library is built with the host gcc against the stand in AVR headers of "Host tools/host_checks" and
+ * linked in as its own object, as it is on the AVR, so DEBOUNCE_INLINE makes the same difference here.  The
+ * stimulus file (the same format as simavr_bench) drives the pins, and every simulated ms the timer ISR and
+ * then one bench_pass() - the same loop of queries as bench_nbutton.c - are timed with the monotonic clock.
+ * The least time two clock reads in a row take is measured first and taken off each call.
+ *
+ * Output is one CSV line per function: name,calls,min,median,p99 (ns).  The median and the 99th percentile
+ * are given rather than the mean and the maximum because the PC is also running other things - a call that
+ * the operating system stops part way through would otherwise swamp them.  Even so the median can move by
+ * half again from one run to the next on a busy PC; the minimum is the steadiest figure.
+ *
+ * These are PC nanoseconds, not AVR cycles - they say nothing about how fast the library is on the
+ * ATmega328P.  They are only good for comparing builds against each other on the same PC (eg plain
+ * against DEBOUNCE_INLINE, or how the ISR grows with the number of buttons), and to see a change move.
+ *
+ **********************************************************************/
+
+#include <avr/io.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "n_button_debounce_v3.h"
+
+#define MAX_STIMULUS 1024
+
+typedef struct
+{
+	uint32_t ms;
+	char port;   // 'B', 'C', 'D' or '*'
+	uint8_t bit;
+	uint8_t level;
+} Stimulus;
+
+typedef struct
+{
+	const char *name;
+	uint32_t calls;
+	uint32_t *ns;  // the time of each call, one per simulated ms
+} Probe;
+
+// the stand in registers - the library's PIND and friends are bytes of these
+volatile uint8_t avrRegs[256];
+volatile uint16_t avrRegs16[16];
+
+void TIMER0_COMPA_vect(void);  // the ISR is a plain function on the PC
+
+static Stimulus stimulus[MAX_STIMULUS];
+static int stimulusCount;
+static uint32_t loopMs;
+static uint64_t clockCost;
+
+volatile uint8_t benchSink;  // the query results go here so the calls can't be optimised away
+
+// one pass of a typical main loop, as in bench_nbutton.c
+__attribute__((noinline)) void bench_pass(void)
+{
+	for (uint8_t i = 0; i < n; i++)
+	{
+		benchSink += is_button_pressed(&button_history[i]);
+		benchSink += is_button_released(&button_history[i]);
+		benchSink += is_button_down(&button_history[i]);
+		benchSink += is_button_up(&button_history[i]);
+	}
+}
+
+static void load_stimulus(const char *fname)
+{
+	FILE *f = fopen(fname, "r");
+	char line[128];
+	if (!f)
+	{
+		perror(fname);
+		exit(1);
+	}
+	while (fgets(line, sizeof line, f))
+	{
+		Stimulus s;
+		char pin[8];
+		unsigned ms, level;
+		if (line[0] == '#' || line[0] == '\n') continue;
+		if (sscanf(line, "loop %u", &ms) == 1)
+		{
+			loopMs = ms;
+			continue;
+		}
+		if (sscanf(line, "%u %7s %u", &ms, pin, &level) != 3 || stimulusCount >= MAX_STIMULUS)
+		{
+			fprintf(stderr, "%s: bad line: %s", fname, line);
+			exit(1);
+		}
+		s.ms = ms;
+		s.port = pin[0];
+		s.bit = (pin[0] == '*') ? 0 : (uint8_t)atoi(pin + 1);
+		s.level = level ? 1 : 0;
+		stimulus[stimulusCount++] = s;
+	}
+	fclose(f);
+}
+
+static void set_pin(char port, uint8_t bit, uint8_t level)
+{
+	volatile uint8_t *pins = (port == 'B') ? &PINB : (port == 'C') ? &PINC : &PIND;
+	if (level) *pins |= (uint8_t)(1 << bit);
+	else *pins &= (uint8_t)~(1 << bit);
+}
+
+static void apply_stimulus(const Stimulus *s)
+{
+	if (s->port == '*')
+	{
+		PINB = PINC = PIND = s->level ? 0xFF : 0x00;
+	} else
+	{
+		set_pin(s->port, s->bit, s->level);
+	}
+}
+
+static uint64_t now_ns(void)
+{
+	struct timespec t;
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	return (uint64_t)t.tv_sec * 1000000000u + t.tv_nsec;
+}
+
+static void probe_add(Probe *probe, uint64_t start, uint64_t end)
+{
+	uint64_t ns = end - start;
+	ns = (ns > clockCost) ? ns - clockCost : 0;
+	probe->ns[probe->calls++] = (ns > UINT32_MAX) ? UINT32_MAX : (uint32_t)ns;
+}
+
+static int compare_ns(const void *a, const void *b)
+{
+	uint32_t x = *(const uint32_t *)a, y = *(const uint32_t *)b;
+	return (x > y) - (x < y);
+}
+
+static void probe_print(Probe *probe)
+{
+	if (!probe->calls) return;
+	qsort(probe->ns, probe->calls, sizeof(uint32_t), compare_ns);
+	printf("%s,%u,%u,%u,%u\n", probe->name, probe->calls, probe->ns[0], probe->ns[probe->calls / 2],
+		probe->ns[(uint32_t)(probe->calls * 99ull / 100)]);
+}
+
+int main(int argc, char *argv[])
+{
+	Probe isr = {"__vector_14"}, pass = {"bench_pass"};
+	uint32_t runMs, loopBase = 0;
+	int next = 0;
+
+	if (argc != 3)
+	{
+		fprintf(stderr, "usage: bench_host stimulus.txt run_ms\n");
+		return 1;
+	}
+	load_stimulus(argv[1]);
+	runMs = atoi(argv[2]);
+	isr.ns = malloc(runMs * sizeof(uint32_t));
+	pass.ns = malloc(runMs * sizeof(uint32_t));
+	if (!isr.ns || !pass.ns)
+	{
+		fprintf(stderr, "bench_host: no memory for %u calls\n", runMs);
+		return 1;
+	}
+
+	// the least time two clock reads in a row take
+	clockCost = UINT64_MAX;
+	for (int i = 0; i < 10000; i++)
+	{
+		uint64_t a = now_ns(), b = now_ns();
+		if (b - a < clockCost) clockCost = b - a;
+	}
+
+	PINB = PINC = PIND = 0xFF;  // all pins start high, button released
+	start_debounce();
+
+	for (uint32_t ms = 0; ms < runMs; ms++)
+	{
+		while (next < stimulusCount && stimulus[next].ms + loopBase <= ms) apply_stimulus(&stimulus[next++]);
+		if (loopMs && next == stimulusCount && ms + 1 >= loopBase + loopMs)
+		{
+			loopBase += loopMs;
+			next = 0;
+		}
+
+		uint64_t start = now_ns();
+		TIMER0_COMPA_vect();
+		probe_add(&isr, start, now_ns());
+
+		start = now_ns();
+		bench_pass();
+		probe_add(&pass, start, now_ns());
+	}
+
+	probe_print(&isr);
+	probe_print(&pass);
+	return 0;
+}
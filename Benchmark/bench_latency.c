@@ -0,0 +1,85 @@
+/*********************************************************************
+ * bench_latency.c - how long a competing interrupt waits while the n button v3 library debounces
+ *
+ * Created: 19/10/2026
+ * Author : agent
+ *
+ * Timer 2 stands in for a UART or motor control interrupt.  It runs in CTC mode at CPU clock / 8 with a
+ * period of LATENCY_PERIOD counts (1600 cycles, 200us), which doesn't divide the 8064 cycle debounce tick, so
+ * over the run its interrupt lands on every part of the tick.  Its ISR reads TCNT2 first thing - the counts
+ * since the compare match, ie how long it waited (in steps of 8 cycles, plus its own entry) - and keeps the
+ * min, average and max.  If the compare flag is already set again by the time it finishes, a whole period
+ * was lost and it counts a miss.
+ *
+ * After LATENCY_SAMPLES interrupts it sends one CSV line out of the UART and stops:
+ *   samples,min,avg,max,missed        (cycles)
+ * "bench.sh latency" builds it with and without DEBOUNCE_NOBLOCK and ISR_SLICE and runs it under simavr.
+ *
+ **********************************************************************/
+
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include "n_button_debounce_v3.h"
+
+#define LATENCY_PRESCALE 8
+#define LATENCY_PERIOD 200     // Timer 2 counts between interrupts
+#define LATENCY_SAMPLES 4000   // 0.8s of them
+#define LATENCY_UBRR 12        // 38400 baud at 8MHz
+
+static volatile uint16_t samples;
+static uint16_t minWait = UINT16_MAX;
+static uint16_t maxWait;
+static uint32_t sumWait;
+static uint16_t missed;
+
+ISR(TIMER2_COMPA_vect)
+{
+	uint16_t wait = TCNT2 * LATENCY_PRESCALE;
+
+	if (samples >= LATENCY_SAMPLES) return;
+	if (wait < minWait) minWait = wait;
+	if (wait > maxWait) maxWait = wait;
+	sumWait += wait;
+	samples++;
+	if (TIFR2 & (1<<OCF2A)) missed++;  // the next match has already happened
+}
+
+static void send_char(char c)
+{
+	while (!(UCSR0A & (1<<UDRE0)));
+	UDR0 = c;
+}
+
+static void send_number(uint32_t value, char after)
+{
+	char text[11];
+	ultoa(value, text, 10);
+	for (char *p = text; *p; p++) send_char(*p);
+	send_char(after);
+}
+
+int main(void)
+{
+	UBRR0 = LATENCY_UBRR;
+	UCSR0B = (1<<TXEN0);
+
+	TCCR2A = (1<<WGM21);   // CTC
+	OCR2A = LATENCY_PERIOD - 1;
+	TIMSK2 = (1<<OCIE2A);
+	TCCR2B = (1<<CS21);    // clock / 8
+
+	start_debounce();      // turns the interrupts on
+
+	while (samples < LATENCY_SAMPLES);
+	cli();
+
+	send_number(samples, ',');
+	send_number(minWait, ',');
+	send_number(sumWait / samples, ',');
+	send_number(maxWait, ',');
+	send_number(missed, '\n');
+
+	while (1);
+}
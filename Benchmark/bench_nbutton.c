@@ -0,0 +1,39 @@
+/*********************************************************************
+ * bench_nbutton.c - benchmark firmware for the n button v3 library
+ *
+ * Created: 19/10/2026
+ * Author : agent
+ *
+ * Calls every query function for every button over and over so simavr_bench can time them,
+ * while the timer ISR keeps debouncing the pins the stimulus file is toggling.
+ *
+ **********************************************************************/
+
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <stdint.h>
+#include "n_button_debounce_v3.h"
+
+volatile uint8_t benchSink;  // the query results go here so the calls can't be optimised away
+
+// one pass of a typical main loop - timed as a whole so builds that inline the queries can be compared too
+__attribute__((noinline)) static void bench_pass(void)
+{
+	for (uint8_t i = 0; i < n; i++)
+	{
+		benchSink += is_button_pressed(&button_history[i]);
+		benchSink += is_button_released(&button_history[i]);
+		benchSink += is_button_down(&button_history[i]);
+		benchSink += is_button_up(&button_history[i]);
+	}
+}
+
+int main(void)
+{
+	start_debounce();
+
+	while (1)
+	{
+		bench_pass();
+	}
+}
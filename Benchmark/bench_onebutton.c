@@ -0,0 +1,30 @@
+/*********************************************************************
+ * bench_onebutton.c - benchmark firmware for the one button v1 library
+ *
+ * Created: 19/10/2026
+ * Author : agent
+ *
+ * Calls every query function over and over so simavr_bench can time them,
+ * while the timer ISR keeps debouncing the pin the stimulus file is toggling.
+ *
+ **********************************************************************/
+
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <stdint.h>
+#include "one_button_debounce_v1.h"
+
+volatile uint8_t benchSink;  // the query results go here so the calls can't be optimised away
+
+int main(void)
+{
+	start_oneButtonDebounce();
+
+	while (1)
+	{
+		benchSink += is_button_pressed(&button_history);
+		benchSink += is_button_released(&button_history);
+		benchSink += is_button_down(&button_history);
+		benchSink += is_button_up(&button_history);
+	}
+}
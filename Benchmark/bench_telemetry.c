@@ -0,0 +1,27 @@
+/*********************************************************************
+ * bench_telemetry.c - test firmware for the UART telemetry of the n button v3 library
+ *
+ * Created: 19/10/2026
+ * Author : agent
+ *
+ * Debounces the pins the stimulus file is toggling and streams the events out of the UART.
+ * "bench.sh telemetry" runs it under simavr and pipes the UART into telemetry_decode.
+ *
+ **********************************************************************/
+
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <stdint.h>
+#include "n_button_debounce_v3.h"
+#include "uart_telemetry.h"
+
+int main(void)
+{
+	start_debounce();
+	start_uart_telemetry();
+
+	while (1)
+	{
+		uart_telemetry_poll();
+	}
+}
@@ -0,0 +1,278 @@
+/*********************************************************************
+ * simavr_bench.c - runs a debounce firmware on a simulated ATmega328P and counts
+ * the CPU cycles spent in chosen functions
+ *
+ * Created: 19/10/2026
+ * Author : agent
+ *
+ * Usage: simavr_bench [--uart file] firmware.elf stimulus.txt run_ms [name=0xaddr ...]
+ *
+ * The name=0xaddr pairs are the functions to time, with the byte address avr-nm gives for them.
+ * A function is timed from its first instruction until its return address is popped off the
+ * stack, so the call instruction and argument set up at the call site are not included.
+ * Functions whose name starts with "__vector_" are ISRs - if one of them interrupts another timed
+ * function its cycles are taken off that function's count.
+ *
+ * The stimulus file drives the button pins, one change per line:
+ *   <time ms> <pin> <level>     eg "12 D4 0" - pin is the port letter and bit, or * for every pin
+ *   loop <ms>                   repeat the whole file every <ms>
+ * Lines starting with # are comments.  All pins start high (button released with pull up).
+ *
+ * Output is one CSV line per timed function: name,calls,min,avg,max (cycles)
+ *
+ * --uart writes every byte the firmware sends out of UART0 to the file, or to stdout if the file
+ * is "-" (the CSV then goes to stderr) so it can be piped into "Host tools/telemetry_decode".
+ *
+ * Build: gcc -O2 -o simavr_bench simavr_bench.c -lsimavr -lelf
+ *
+ * Not yet built or run - see the note at the top of bench.sh.
+ *
+ **********************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <simavr/sim_avr.h>
+#include <simavr/sim_elf.h>
+#include <simavr/avr_ioport.h>
+#include <simavr/avr_uart.h>
+
+#define MAX_PROBES 16
+#define MAX_STIMULUS 1024
+#define MAX_DEPTH 8
+
+typedef struct
+{
+	char name[48];
+	uint32_t addr;
+	uint8_t isr;
+	uint32_t calls;
+	uint64_t total;
+	uint64_t min;
+	uint64_t max;
+} Probe;
+
+typedef struct
+{
+	uint32_t ms;
+	char port;   // 'B', 'C', 'D' or '*'
+	uint8_t bit;
+	uint8_t level;
+} Stimulus;
+
+typedef struct
+{
+	Probe *probe;
+	uint64_t start;
+	uint16_t sp;
+	uint64_t isrCycles;  // cycles taken by ISRs that interrupted this call
+} Active;
+
+static Probe probes[MAX_PROBES];
+static int probeCount;
+static Stimulus stimulus[MAX_STIMULUS];
+static int stimulusCount;
+static uint32_t loopMs;
+
+static const char ports[] = "BCD";
+
+static void load_stimulus(const char *fname)
+{
+	FILE *f = fopen(fname, "r");
+	char line[128];
+	if (!f)
+	{
+		perror(fname);
+		exit(1);
+	}
+	while (fgets(line, sizeof line, f))
+	{
+		Stimulus s;
+		char pin[8];
+		unsigned ms, level;
+		if (line[0] == '#' || line[0] == '\n') continue;
+		if (sscanf(line, "loop %u", &ms) == 1)
+		{
+			loopMs = ms;
+			continue;
+		}
+		if (sscanf(line, "%u %7s %u", &ms, pin, &level) != 3 || stimulusCount >= MAX_STIMULUS)
+		{
+			fprintf(stderr, "%s: bad line: %s", fname, line);
+			exit(1);
+		}
+		s.ms = ms;
+		s.port = pin[0];
+		s.bit = (pin[0] == '*') ? 0 : (uint8_t)atoi(pin + 1);
+		s.level = level ? 1 : 0;
+		stimulus[stimulusCount++] = s;
+	}
+	fclose(f);
+}
+
+static void set_pin(avr_t *avr, char port, uint8_t bit, uint8_t level)
+{
+	avr_irq_t *irq = avr_io_getirq(avr, AVR_IOCTL_IOPORT_GETIRQ(port), bit);
+	if (irq) avr_raise_irq(irq, level);
+}
+
+static void apply_stimulus(avr_t *avr, const Stimulus *s)
+{
+	if (s->port == '*')
+	{
+		for (const char *p = ports; *p; p++)
+			for (uint8_t b = 0; b < 8; b++)
+				set_pin(avr, *p, b, s->level);
+	} else
+	{
+		set_pin(avr, s->port, s->bit, s->level);
+	}
+}
+
+static void uart_byte(struct avr_irq_t *irq, uint32_t value, void *param)
+{
+	FILE *f = param;
+	(void)irq;
+	putc((int)(value & 0xFF), f);
+	fflush(f);
+}
+
+int main(int argc, char *argv[])
+{
+	elf_firmware_t fw;
+	avr_t *avr;
+	Active stack[MAX_DEPTH];
+	int depth = 0;
+	int next = 0;
+	uint32_t loopBase = 0;
+	uint64_t endCycle, cyclesPerMs;
+	FILE *uartOut = NULL;
+	FILE *report = stdout;
+
+	if (argc > 2 && strcmp(argv[1], "--uart") == 0)
+	{
+		if (strcmp(argv[2], "-") == 0)
+		{
+			uartOut = stdout;
+			report = stderr;
+		} else if (!(uartOut = fopen(argv[2], "wb")))
+		{
+			perror(argv[2]);
+			return 1;
+		}
+		argv += 2;
+		argc -= 2;
+	}
+	if (argc < 4)
+	{
+		fprintf(stderr, "usage: simavr_bench [--uart file] firmware.elf stimulus.txt run_ms [name=0xaddr ...]\n");
+		return 1;
+	}
+	for (int i = 4; i < argc && probeCount < MAX_PROBES; i++)
+	{
+		Probe *p = &probes[probeCount++];
+		char *eq = strchr(argv[i], '=');
+		if (!eq)
+		{
+			fprintf(stderr, "bad probe %s\n", argv[i]);
+			return 1;
+		}
+		snprintf(p->name, sizeof p->name, "%.*s", (int)(eq - argv[i]), argv[i]);
+		p->addr = (uint32_t)strtoul(eq + 1, NULL, 16);
+		p->isr = (strncmp(p->name, "__vector_", 9) == 0);
+		p->min = UINT64_MAX;
+	}
+	load_stimulus(argv[2]);
+
+	memset(&fw, 0, sizeof fw);
+	if (elf_read_firmware(argv[1], &fw) != 0)
+	{
+		fprintf(stderr, "can't load %s\n", argv[1]);
+		return 1;
+	}
+	avr = avr_make_mcu_by_name("atmega328p");
+	if (!avr)
+	{
+		fprintf(stderr, "simavr has no atmega328p core\n");
+		return 1;
+	}
+	avr_init(avr);
+	avr->frequency = fw.frequency ? fw.frequency : 8000000;
+	avr_load_firmware(avr, &fw);
+
+	if (uartOut)
+	{
+		// stop simavr printing the UART itself and take the raw bytes instead
+		uint32_t flags = 0;
+		avr_ioctl(avr, AVR_IOCTL_UART_GET_FLAGS('0'), &flags);
+		flags &= ~AVR_UART_FLAG_STDIO;
+		avr_ioctl(avr, AVR_IOCTL_UART_SET_FLAGS('0'), &flags);
+		avr_irq_register_notify(avr_io_getirq(avr, AVR_IOCTL_UART_GETIRQ('0'), UART_IRQ_OUTPUT), uart_byte, uartOut);
+	}
+
+	for (const char *p = ports; *p; p++)
+		for (uint8_t b = 0; b < 8; b++)
+			set_pin(avr, *p, b, 1);
+
+	cyclesPerMs = avr->frequency / 1000;
+	endCycle = (uint64_t)atoi(argv[3]) * cyclesPerMs;
+
+	while (avr->cycle < endCycle)
+	{
+		uint64_t nowMs = avr->cycle / cyclesPerMs;
+		int state;
+
+		while (next < stimulusCount && loopBase + stimulus[next].ms <= nowMs)
+		{
+			apply_stimulus(avr, &stimulus[next++]);
+			if (next == stimulusCount && loopMs)
+			{
+				next = 0;
+				loopBase += loopMs;
+			}
+		}
+
+		state = avr_run(avr);
+		if (state == cpu_Done || state == cpu_Crashed) break;
+
+		uint16_t sp = avr->data[R_SPL] | (avr->data[R_SPH] << 8);
+
+		// has the innermost timed call returned?
+		while (depth > 0 && sp > stack[depth - 1].sp)
+		{
+			Active *a = &stack[--depth];
+			uint64_t cycles = avr->cycle - a->start - a->isrCycles;
+			Probe *p = a->probe;
+			p->calls++;
+			p->total += cycles;
+			if (cycles < p->min) p->min = cycles;
+			if (cycles > p->max) p->max = cycles;
+			if (p->isr && depth > 0) stack[depth - 1].isrCycles += avr->cycle - a->start;
+		}
+		// or has a timed function just been entered?
+		for (int i = 0; i < probeCount; i++)
+		{
+			if (avr->pc == probes[i].addr && depth < MAX_DEPTH)
+			{
+				stack[depth].probe = &probes[i];
+				stack[depth].start = avr->cycle;
+				stack[depth].sp = sp;
+				stack[depth].isrCycles = 0;
+				depth++;
+				break;
+			}
+		}
+	}
+
+	for (int i = 0; i < probeCount; i++)
+	{
+		Probe *p = &probes[i];
+		if (p->calls == 0)
+			fprintf(report, "%s,0,0,0,0\n", p->name);
+		else
+			fprintf(report, "%s,%u,%llu,%llu,%llu\n", p->name, p->calls, (unsigned long long)p->min,
+				(unsigned long long)(p->total / p->calls), (unsigned long long)p->max);
+	}
+	return 0;
+}
@@ -32,54 +32,25 @@ int main(void)
 	CLEAR_BIT(PORTD,LED); //turn the LED off
 	
 
+	ButtonSnapshot buttons;
+
     while (1) 
     {
 
-		// test the buttons
-		
-		//------------------- Button 0
-			
-		if (is_button_down(&button_history[0]))
-		{
-			SET_BIT(PORTD,LED);
-		}
-		if (is_button_up(&button_history[0]))
-		{
-			CLEAR_BIT(PORTD,LED);
-		}
+		// test the buttons - the snapshot gives every button as the ISR last saw them, all from the same sample
+		get_button_snapshot(&defaultBank, &buttons);
 		
-		//------------------- Button 1
-				
-		if (is_button_down(&button_history[1]))
-		{
-			SET_BIT(PORTD,LED);
+		for (uint8_t i = 0; i < n; i++)
+		{
+			if (buttons.down & ((ButtonMask)1<<i))
+			{
+				SET_BIT(PORTD,LED);
+			}
+			if (buttons.up & ((ButtonMask)1<<i))
+			{
+				CLEAR_BIT(PORTD,LED);
+			}
 		}
-		if (is_button_up(&button_history[1]))
-		{
-			CLEAR_BIT(PORTD,LED);
-		}
-		
-		//------------------- Button 2
-				
-		if (is_button_down(&button_history[2]))
-		{
-			SET_BIT(PORTD,LED);
-		}
-		if (is_button_up(&button_history[2]))
-		{
-			CLEAR_BIT(PORTD,LED);
-		}
-		
-		//------------------- Button 3
-		
-		if (is_button_down(&button_history[3]))
-		{
-			SET_BIT(PORTD,LED);
-		}
-		if (is_button_up(&button_history[3]))
-		{
-			CLEAR_BIT(PORTD,LED);
-		}			
     }
 } //end of main.c
 	
@@ -19,17 +19,47 @@
 #include <stdint.h>
 #include "BitManipulation.h"
 #include "n_button_debounce_v3.h"
+#include "n_button_debounce_v3_inline.h"
+#include "history_lut.h"
+#include <util/atomic.h>
+#include <util/delay.h>
+#if ENCODERS
+#include "encoder.h"
+#endif
+#if DEBOUNCE_PARAMS
+#include "debounce_params.h"
+#endif
+#if PRIORITY_INPUTS
+#include "priority_input.h"
+#endif
+#if FLIGHT_RECORDER
+#include "flight_recorder.h"
+#endif
 
-uint8_t btnSmplePeriod = 5; // ie sample the buttons every 5ms
-typedef struct
-{
-	uint8_t terminal;   // the actual pin the button is connected to
-	volatile uint8_t *inputPort;  // the port to be read for that button	
-	volatile uint8_t *outputPort; // the port to write to if setting up internal pullup resistors
-	volatile uint8_t *ddr;
-} Buttons;
+// the debounce rules (PRESSED_PATTERN etc) are in n_button_debounce_v3_inline.h
+#define V3_CLASSIFY(h) HISTORY_CLASSIFY(h, PRESSED_MASK, PRESSED_PATTERN, RELEASED_MASK, RELEASED_PATTERN)
+
+// the state of every possible history byte, so one lpm instruction answers all the questions about a button
+const uint8_t historyClass[256] PROGMEM = { HISTORY_TABLE(V3_CLASSIFY) };
+
+#define HISTORY_CLASS_NEEDED (BUTTON_DECISIONS || BUTTON_SNAPSHOT)  // features that look each history up in the table
+
+// Timer 0 runs in CTC mode, so a tick is TICK_COMPARE + 1 counts of the prescaled clock
+#define TICK_COMPARE 0x7D  // at 8MHz clock and 0xFA at 16MHz
+#define TICK_PRESCALE 64
+
+//Global variables
+volatile uint64_t milliCtr;
+volatile uint64_t startCnt;  //dont set these to 0 to ensure the compiler puts the variables in the .BSS section of the code (see Lib-c manual)
+uint8_t button_history[n];
 
 //	format is {pin number, input port number, output port number, data direction register of the port}
+//	and with BUTTON_MODES a fifth value, the mode (see note 22 in n_button_debounce_v3.h), can follow
+//	BUTTON_CONFIG can name a header holding the btn[] table instead, eg BUTTON_CONFIG="my_buttons.h" in the
+//	compiler symbols - the benchmark uses this to build the library for different numbers of buttons.
+#ifdef BUTTON_CONFIG
+#include BUTTON_CONFIG
+#else
 Buttons btn[n] = 
 	{
 	{0x04, (uint8_t*)0x29, (uint8_t*)0x2B, (uint8_t*)0x2A}, 
@@ -39,6 +69,21 @@ Buttons btn[n] =
 	};
 	// Add more buttons in the same way up to 8.  If more are needed then change the variable definitions too,
 	// to 16 bit numbers
+#endif
+
+// the default bank is the buttons above
+// Sampled every 1ms, which is what the earlier versions actually did (their 5ms check let every tick through
+// once the first 5ms had passed), so the press and release times stay the same.  Make it 5 for a slower panel
+const DebounceBankConfig defaultConfig = {btn, n, 1, 0, historyClass}; // ie sample the buttons every 1ms, events numbered from 0
+#if BUTTON_DECISIONS
+static ButtonState defaultState[n];
+DebounceBank defaultBank = {.config = &defaultConfig, .history = button_history, .state = defaultState};
+#else
+DebounceBank defaultBank = {.config = &defaultConfig, .history = button_history};
+#endif
+
+static DebounceBank *volatile firstBank;  // the banks the tick services, linked through next
+static uint8_t bankCount;  // banks added so far, for their slot numbers
 	
 
 /**************************************************************  
@@ -72,18 +117,429 @@ Buttons btn[n] =
 
 
 
-//Interrupt handling routines
-//Timer 0
-//increment a global variable (milliCtr) once each time
-ISR(TIMER0_COMPA_vect)
+#if ISR_STATS
+// The ISR is timed with Timer 1 running at the CPU clock, so one count is one cycle.  The push/pop of
+// registers on entry and exit of the ISR happen outside the measurement, allow roughly another 50 cycles for those.
+#define ISR_STATS_TICK_CYCLES ((TICK_COMPARE + 1UL) * TICK_PRESCALE) // CPU cycles in one tick - 8064 at 8MHz
+#define ISR_STATS_WINDOW 1000  // number of ticks the average and CPU load are worked out over - ie 1 second
+
+static uint16_t isrMin = UINT16_MAX;
+static uint16_t isrMax;
+static uint16_t isrOverruns;
+static uint32_t isrWindowSum;   // cycles used so far in the current window
+static uint16_t isrWindowTicks;
+static uint32_t isrLastSum;     // totals of the last complete window - these are what get_isr_stats() reports
+static uint16_t isrLastTicks;
+
+static void isr_stats_record(uint16_t cycles)
+{
+	if (cycles < isrMin) isrMin = cycles;
+	if (cycles > isrMax) isrMax = cycles;
+	// the compare match flag gets set again if the next tick came due while we were still in the ISR
+	if ((cycles >= ISR_STATS_TICK_CYCLES) || (TIFR0 & (1<<OCF0A)))
+	{
+		if (isrOverruns < UINT16_MAX) isrOverruns++;
+	}
+	isrWindowSum += cycles;
+	isrWindowTicks++;
+	if (isrWindowTicks >= ISR_STATS_WINDOW)
+	{
+		isrLastSum = isrWindowSum;
+		isrLastTicks = isrWindowTicks;
+		isrWindowSum = 0;
+		isrWindowTicks = 0;
+	}
+}
+#endif
+
+
+#if BUTTON_DECISIONS
+// A decision is the history matching the pressed or released pattern, or reaching all 1's or all 0's in case a
+// bouncy press skipped the pattern, so every press gets exactly one matching release.
+static uint8_t button_decision(ButtonState *state, uint8_t cls)
+{
+	if (!state->down)
+	{
+		if (cls & (HISTORY_PRESSED | HISTORY_DOWN))
+		{
+			state->down = 1;
+			return BUTTON_PRESSED;
+		}
+	} else if (cls & (HISTORY_RELEASED | HISTORY_UP))
+	{
+		state->down = 0;
+		return BUTTON_RELEASED;
+	}
+	return 0;
+}
+#endif
+
+
+#if EDGE_TRACKING
+// A change is followed from the first sample that disagrees with the debounced state to the sample where the press
+// or release is decided.  If the pin settles back without a decision it was a glitch and the change is forgotten.
+// Returns the age the change had reached when it was decided, or 0 if nothing was decided this sample.
+static uint8_t edge_track(ButtonState *state, uint8_t history, uint8_t cls, uint8_t wasDown, uint8_t event)
+{
+	uint8_t age = state->edgeAge;
+	
+	if (age)
+	{
+		if (age < UINT8_MAX) age++;
+	} else if ((history & 0x01) != wasDown)
+	{
+		age = 1;  // first edge
+	}
+	
+	if (event)
+	{
+		state->edgeAge = 0;
+		return age;
+	}
+	if (cls & (wasDown ? HISTORY_DOWN : HISTORY_UP)) age = 0;  // settled back where it was, so it was a glitch
+	state->edgeAge = age;
+	return 0;
+}
+#endif
+
+
+#if LATENCY_HISTOGRAM
+static void latency_count(uint8_t *bucket, uint8_t samples)
+{
+	uint8_t b = 0;
+	while ((samples > 1) && (b < LATENCY_BUCKETS - 1))
+	{
+		samples >>= 1;
+		b++;
+	}
+	if (bucket[b] < UINT8_MAX) bucket[b]++;
+}
+#endif
+
+
+#if BOUNCE_STATS
+// Every change of the raw pin while a press or release is being followed is counted.  The first one is the real
+// edge and the rest are bounces.  The bounce time runs from the first edge to the last change.
+static void bounce_track(ButtonState *state, uint8_t history, uint8_t decidedAge)
+{
+	uint8_t age = decidedAge ? decidedAge : state->edgeAge;
+	
+	if (!age)
+	{
+		state->bounceChanges = 0;  // nothing in progress, or it was a glitch
+		return;
+	}
+	if ((history ^ (history >> 1)) & 0x01)
+	{
+		if (state->bounceChanges < UINT8_MAX) state->bounceChanges++;
+		state->bounceLastAge = age;
+	}
+	if (decidedAge)
+	{
+		BounceStats *stats = &state->bounce;
+		uint8_t bounces = state->bounceChanges ? state->bounceChanges - 1 : 0;
+		uint8_t time = state->bounceChanges ? state->bounceLastAge - 1 : 0;
+		
+		if (stats->changes < UINT16_MAX) stats->changes++;
+		stats->bounces = (stats->bounces > UINT16_MAX - bounces) ? UINT16_MAX : stats->bounces + bounces;
+		stats->lastBounces = bounces;
+		if (time > stats->maxBounceTime) stats->maxBounceTime = time;
+		// running average over about the last 8, kept in 1/16ths of a sample
+		stats->meanBounceTime = stats->meanBounceTime - (stats->meanBounceTime >> 3) + (time << 1);
+		state->bounceChanges = 0;
+	}
+}
+#endif
+
+
+#if BUTTON_EVENTS
+// Single producer (the ISR), single consumer (the main loop) ring buffer.  The indexes are single bytes so
+// reading and writing them is atomic and neither side has to turn interrupts off.
+static ButtonEvent eventQueue[EVENT_QUEUE_SIZE];
+static volatile uint8_t eventHead;  // written by the ISR
+static volatile uint8_t eventTail;  // written by get_button_event()
+static volatile uint16_t eventDrops;
+
+static void push_event_now(uint8_t button, uint8_t type)
+{
+	uint8_t head = eventHead;
+	uint8_t next = (head + 1) & (EVENT_QUEUE_SIZE - 1);
+	if (next == eventTail)
+	{
+		if (eventDrops < UINT16_MAX) eventDrops++;  // queue full, the main loop isn't keeping up
+		return;
+	}
+	eventQueue[head].button = button;
+	eventQueue[head].type = type;
+	eventQueue[head].time = (uint16_t)milliCtr;
+	eventHead = next;
+}
+
+// With DEBOUNCE_NOBLOCK a pin interrupt (priority_input.c) can queue an event while the tick is part way
+// through one, so the two are kept apart
+static void push_event(uint8_t button, uint8_t type)
+{
+#if DEBOUNCE_NOBLOCK
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		push_event_now(button, type);
+	}
+#else
+	push_event_now(button, type);
+#endif
+}
+#endif
+
+
+#if BUTTON_CHORDS
+enum { CHORD_IDLE, CHORD_HOLDING, CHORD_FIRED, CHORD_BLOCKED };
+
+// Each chord is checked with a couple of AND/compares on the whole bank's debounced state.  The hold time
+// starts again whenever the chord isn't complete, and a chord that fired, or was started in the wrong order,
+// has to be let go of completely before it can fire again.
+static void chord_track(DebounceBank *bank, ButtonMask down)
 {
-	if (milliCtr-startCnt >= btnSmplePeriod)
+	for (Chord *chord = bank->chords; chord; chord = chord->next)
 	{
-		for (uint8_t i = 0; i < n; i++)
+		const ChordConfig *cc = chord->config;
+		ButtonMask mine = down & cc->mask;
+		ButtonMask seen = cc->exact ? down : mine;
+		
+		if (!mine)  // all of its buttons let go
 		{
-			update_button(&button_history[i], btn[i].inputPort, btn[i].terminal);
+			if (chord->state == CHORD_FIRED) push_event(cc->id, BUTTON_CHORD_END);
+			chord->state = CHORD_IDLE;
+			continue;
+		}
+		if (chord->state == CHORD_IDLE)  // the first of its buttons has just gone down
+		{
+			chord->heldMs = 0;
+			chord->state = CHORD_HOLDING;
+			if ((cc->first != CHORD_ANY_ORDER) && (mine != ((ButtonMask)1 << cc->first))) chord->state = CHORD_BLOCKED;
+		}
+		if (seen == cc->mask)
+		{
+			if (chord->state == CHORD_HOLDING)
+			{
+				if (chord->heldMs >= cc->holdMs)
+				{
+					push_event(cc->id, BUTTON_CHORD);
+					chord->state = CHORD_FIRED;
+				} else
+				{
+					chord->heldMs += bank->samplePeriod;
+				}
+			}
+		} else if (chord->state == CHORD_FIRED)
+		{
+			push_event(cc->id, BUTTON_CHORD_END);
+			chord->state = CHORD_BLOCKED;
+		} else
+		{
+			chord->heldMs = 0;
 		}
 	}
+}
+#endif
+
+
+#if DEBOUNCE_NOBLOCK
+// The banks are sampled with interrupts on, so the tick copies the ports first and the banks read the copy -
+// every button then sees the pins as they were at the tick, however late its bank gets done
+static uint8_t pinLatch[3];               // PINB, PINC and PIND
+static volatile uint8_t debounceBusy;     // 1 while a tick is working on the banks
+static volatile uint8_t tickBacklog;      // ticks that came in while it was, still to be done
+
+static void latch_pins(void)
+{
+	pinLatch[0] = PINB;
+	pinLatch[1] = PINC;
+	pinLatch[2] = PIND;
+}
+
+// where to read a button's pin from - its port's copy, or the port itself if it isn't one that is latched
+static volatile uint8_t *latched_port(volatile uint8_t *port)
+{
+	if (port == &PINB) return &pinLatch[0];
+	if (port == &PINC) return &pinLatch[1];
+	if (port == &PIND) return &pinLatch[2];
+	return port;
+}
+#define BUTTON_PORT(b) latched_port((b)->inputPort)
+#else
+#define BUTTON_PORT(b) ((b)->inputPort)
+#endif
+
+
+#if BUTTON_MODES
+// which of a bank's polarity masks goes with a port - PINB, PINC, PIND, then one for any other port
+static uint8_t port_slot(volatile uint8_t *port)
+{
+	if (port == &PINB) return 0;
+	if (port == &PINC) return 1;
+	if (port == &PIND) return 2;
+	return 3;
+}
+#endif
+
+
+// sample buttons first to last-1 of one bank and work out what the options need.  The work for the whole bank
+// (snapshot, chords, trace) is done when its last button has been sampled
+static void sample_bank(DebounceBank *bank, uint8_t first, uint8_t last)
+{
+	const DebounceBankConfig *config = bank->config;
+	const Buttons *b = config->buttons + first;
+	uint8_t *history = bank->history;
+#if BUTTON_CHORDS
+	ButtonMask downMask = 0;  // the debounced state of the whole bank, for the chords
+	ButtonMask downBit = (ButtonMask)1 << first;
+#endif
+#if BUTTON_SNAPSHOT
+	// the snapshot is published with a sequence count - odd while the ISR is writing and even again when it has
+	// finished, so get_button_snapshot() can tell if it was part way through a copy and simply copy again
+	ButtonSnapshot snap = {0};
+	ButtonMask bit = (ButtonMask)1 << first;
+#endif
+#if BUTTON_MODES
+	volatile uint8_t *port = 0;  // the port pins was read from
+	uint8_t pins = 0;            // and its word, XORed so a pressed button's bit is 1 whatever its mode
+#endif
+#if ISR_SLICE && (BUTTON_SNAPSHOT || BUTTON_CHORDS)
+	if (first)  // carry on from the bank's earlier slices this period
+	{
+#if BUTTON_CHORDS
+		downMask = bank->sliceDown;
+#endif
+#if BUTTON_SNAPSHOT
+		snap = bank->sliceSnap;
+#endif
+	}
+#endif
+	
+	for (uint8_t i = first; i < last; i++, b++)
+	{
+#if BUTTON_MODES
+		// a port's buttons are usually together in the table, so its word is read and XORed once, when the port
+		// changes, rather than for every button
+		if (b->inputPort != port)
+		{
+			port = b->inputPort;
+			pins = *BUTTON_PORT(b) ^ bank->polarity[port_slot(port)];
+		}
+		history[i] = debounce_shift(history[i], (pins >> b->terminal) & 0x01);
+#elif DEBOUNCE_INLINE
+		history[i] = debounce_shift(history[i], debounce_read(*BUTTON_PORT(b), b->terminal));
+#else
+		update_button(&history[i], BUTTON_PORT(b), b->terminal);
+#endif
+#if HISTORY_CLASS_NEEDED
+		uint8_t cls = pgm_read_byte(&config->classTable[history[i]]);
+#endif
+#if BUTTON_SNAPSHOT
+		if (cls & HISTORY_DOWN) snap.down |= bit;
+		if (cls & HISTORY_UP) snap.up |= bit;
+		if (cls & HISTORY_PRESSED) snap.pressed |= bit;
+		if (cls & HISTORY_RELEASED) snap.released |= bit;
+		bit <<= 1;
+#endif
+#if BUTTON_DECISIONS
+		ButtonState *state = &bank->state[i];
+#endif
+#if EDGE_TRACKING
+		uint8_t wasDown = state->down;
+#endif
+#if BUTTON_DECISIONS
+		uint8_t event = button_decision(state, cls);
+#endif
+#if BUTTON_CHORDS
+		if (state->down) downMask |= downBit;
+		downBit <<= 1;
+#endif
+#if EDGE_TRACKING
+		uint8_t decidedAge = edge_track(state, history[i], cls, wasDown, event);
+#endif
+#if LATENCY_HISTOGRAM
+		if (decidedAge) latency_count((event == BUTTON_PRESSED) ? state->latency.press : state->latency.release, decidedAge - 1);
+#endif
+#if BOUNCE_STATS
+		bounce_track(state, history[i], decidedAge);
+#endif
+#if BUTTON_EVENTS
+		if (event) push_event(config->firstId + i, event);
+#endif
+	}
+#if ISR_SLICE
+	if (last < config->count)  // more slices to come
+	{
+#if BUTTON_CHORDS
+		bank->sliceDown = downMask;
+#endif
+#if BUTTON_SNAPSHOT
+		bank->sliceSnap = snap;
+#endif
+		return;
+	}
+#endif
+#if BUTTON_SNAPSHOT
+	bank->snapshotSeq++;
+	bank->snapshot = snap;
+	bank->snapshotSeq++;
+#endif
+#if BUTTON_CHORDS
+	chord_track(bank, downMask);
+#endif
+#if FLIGHT_RECORDER
+	flight_record(bank);
+#endif
+#if DEBOUNCE_TRACE
+	debounce_trace(bank);
+#endif
+}
+
+
+#if ISR_SLICE
+// sampled ISR_SLICE buttons a tick, a bank needs at least this many ms per sample period to get round them all
+static uint8_t slice_period(const DebounceBank *bank, uint8_t ms)
+{
+	uint8_t slices = (bank->config->count + ISR_SLICE - 1) / ISR_SLICE;
+	return (ms < slices) ? slices : ms;
+}
+#endif
+
+
+// the banks' share of a tick - sample each bank when its period (or its next slice) comes round.  ISR_SLICE
+// is a limit for each bank, so a tick can sample ISR_SLICE buttons from every bank
+static void sample_banks(void)
+{
+	for (DebounceBank *bank = firstBank; bank; bank = bank->next)
+	{
+#if ISR_SLICE
+		// a new period starts the bank from its first button again, then each tick samples the next slice
+		if (--bank->divider == 0)
+		{
+			bank->divider = bank->samplePeriod;
+			bank->sliceNext = 0;
+		}
+		uint8_t first = bank->sliceNext;
+		if (first < bank->config->count)
+		{
+			uint8_t last = ((uint8_t)(bank->config->count - first) > ISR_SLICE) ? first + ISR_SLICE : bank->config->count;
+			bank->sliceNext = last;
+			sample_bank(bank, first, last);
+		}
+#else
+		if (--bank->divider == 0)
+		{
+			bank->divider = bank->samplePeriod;
+			sample_bank(bank, 0, bank->config->count);
+		}
+#endif
+	}
+}
+
+
+static void count_ms(void)
+{
 	// consider what happens when it overflows...
 	// when overflow is due at next interrupt instance then
 	// reset starting counter
@@ -94,10 +550,53 @@ ISR(TIMER0_COMPA_vect)
 	{
 		milliCtr++;
 	}
-	
-};
+}
 
 
+//Interrupt handling routines
+//Timer 0
+//increment a global variable (milliCtr) once each time and sample each bank when its period comes round
+ISR(TIMER0_COMPA_vect)
+{
+#if ISR_STATS
+	uint16_t isrStart = TCNT1;
+#endif
+#if ENCODERS
+	sample_encoders();
+#endif
+#if PRIORITY_INPUTS
+	priority_tick();
+#endif
+#if DEBOUNCE_NOBLOCK
+	// Only the above, the ms count and the latch are done with interrupts off.  A tick that comes in while the
+	// banks of the last one are still being worked on just leaves them a note to go round again.
+	count_ms();
+	if (debounceBusy)
+	{
+		if (tickBacklog < UINT8_MAX) tickBacklog++;
+	} else
+	{
+		debounceBusy = 1;
+		for (;;)
+		{
+			latch_pins();
+			sei();  // the other interrupts, and the next tick, can get in from here
+			sample_banks();
+			cli();
+			if (!tickBacklog) break;
+			tickBacklog--;
+		}
+		debounceBusy = 0;
+	}
+#else
+	sample_banks();
+	count_ms();
+#endif
+#if ISR_STATS
+	isr_stats_record(TCNT1 - isrStart);
+#endif
+};
+
 
 
 	
@@ -112,25 +611,152 @@ ISR(TIMER0_COMPA_vect)
 		
 		// The overflow interrupt is TIMER0_OVF_vect
 		TIMSK0 |= (1<<1);  // set Timer/Counter0 Interrupt Mask Register - enable timer 0 output compare interrupt
-		OCR0A = 0x7D; // at 8MHz clock and 0xFA at 16MHz lock // set Timer/Counter Register - counter start point for 1ms counts
+		OCR0A = TICK_COMPARE; // set Timer/Counter Register - counter start point for 1ms counts
 		TCCR0A = 0x02; // set Timer/Counter Control Register A to "CTC mode"
-		TCCR0B = 0x03; // set Timer/Counter Control Register B, 64 prescaler
+		TCCR0B = 0x03; // set Timer/Counter Control Register B, 64 prescaler (TICK_PRESCALE)
+		
+		startCnt = milliCtr;
+#if DEBOUNCE_PARAMS
+		load_debounce_params();  // before the default bank is added, so it starts with them
+#endif
+#if ISR_STATS
+		TCCR1A = 0x00; // Timer 1 normal mode, free running
+		TCCR1B = 0x01; // no prescaler so Timer 1 counts CPU cycles
+#endif
+		add_debounce_bank(&defaultBank);
+	}
+	
+	
+	// 1 if the tick is already sampling bank
+	static uint8_t bank_is_added(const DebounceBank *bank)
+	{
+		for (const DebounceBank *b = firstBank; b; b = b->next)
+		{
+			if (b == bank) return 1;
+		}
+		return 0;
+	}
+	
+	
+	// set the bank's pins up and have the timer tick start sampling it.  A bank that has already been added is
+	// left alone - linking it in again would point it at itself and the ISR would go round it for ever
+	void add_debounce_bank(DebounceBank *bank)
+	{
+		const DebounceBankConfig *config = bank->config;
+		
+		if (bank_is_added(bank)) return;
 		
 		//for the button input pins, set the registers up.
-		for (uint8_t i = 0; i<n; i++)
+#if BUTTON_MODES
+		for (uint8_t k = 0; k < sizeof(bank->polarity); k++) bank->polarity[k] = 0xFF;
+#endif
+		for (uint8_t i = 0; i<config->count; i++)
 		{
-			CLEAR_BIT(*btn[i].ddr, btn[i].terminal);  //clear bits to configure as input for buttons - should be 0 by default anyway but just in case.
-			SET_BIT(*btn[i].outputPort, btn[i].terminal); //set bits to turn on pullup resistor
-			//*btn[i].outputPort |= (1<<btn[i].terminal);
+			CLEAR_BIT(*config->buttons[i].ddr, config->buttons[i].terminal);  //clear bits to configure as input for buttons - should be 0 by default anyway but just in case.
+#if BUTTON_MODES
+			if (config->buttons[i].mode & BUTTON_ACTIVE_HIGH) CLEAR_BIT(bank->polarity[port_slot(config->buttons[i].inputPort)], config->buttons[i].terminal);
+			if (!debounce_pull_up(config->buttons[i].mode))
+			{
+				CLEAR_BIT(*config->buttons[i].outputPort, config->buttons[i].terminal); //pullup off, the input drives the pin
+				continue;
+			}
+#endif
+			SET_BIT(*config->buttons[i].outputPort, config->buttons[i].terminal); //set bits to turn on pullup resistor
+		}
+		bank->slot = bankCount++;
+#if DEBOUNCE_PARAMS
+		bank->samplePeriod = param_sample_period(bank->slot, config->samplePeriod);
+#else
+		bank->samplePeriod = config->samplePeriod;
+#endif
+#if ISR_SLICE
+		bank->samplePeriod = slice_period(bank, bank->samplePeriod);
+		bank->sliceNext = config->count;  // nothing to sample until its first period starts
+#endif
+		bank->divider = bank->samplePeriod;
+#if SEED_HISTORY
+		seed_debounce_bank(bank);  // before the tick can see it
+#endif
+		ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+		{
+			bank->next = firstBank;
+			firstBank = bank;
 		}
-		startCnt = milliCtr;
 	}
 	
 	
+	// change how often a bank is sampled while it is running.  With DEBOUNCE_PARAMS the new period is also put
+	// in debounceParams, ready for save_debounce_params()
+	void set_bank_sample_period(DebounceBank *bank, uint8_t ms)
+	{
+		if (ms == 0) return;
+#if ISR_SLICE
+		ms = slice_period(bank, ms);
+#endif
+		ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+		{
+			bank->samplePeriod = ms;
+			if (bank->divider > ms) bank->divider = ms;
+		}
+#if DEBOUNCE_PARAMS
+		if (bank->slot < DEBOUNCE_PARAM_BANKS) debounceParams.samplePeriod[bank->slot] = ms;
+#endif
+	}
+	
+	
+	// read every pin of the bank once and start the debounce from there - a button that is held reads as down
+	// straight away, with no pressed edge or event on the way, and one that isn't reads as up
+	void seed_debounce_bank(DebounceBank *bank)
+	{
+		const DebounceBankConfig *config = bank->config;
+		const Buttons *b = config->buttons;
+#if BUTTON_SNAPSHOT
+		ButtonSnapshot snap = {0};
+		ButtonMask bit = 1;
+#endif
+		
+		_delay_us(SEED_SETTLE_US);
+		ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+		{
+			for (uint8_t i = 0; i < config->count; i++, b++)
+			{
+#if BUTTON_MODES
+				uint8_t down = debounce_read_polarity(*b->inputPort, debounce_polarity(b->mode), b->terminal);
+#else
+				uint8_t down = read_button(b->inputPort, b->terminal);
+#endif
+				bank->history[i] = down ? 0xFF : 0x00;
+#if BUTTON_DECISIONS
+				bank->state[i].down = down;
+#endif
+#if EDGE_TRACKING
+				bank->state[i].edgeAge = 0;
+#endif
+#if BOUNCE_STATS
+				bank->state[i].bounceChanges = 0;
+#endif
+#if BUTTON_SNAPSHOT
+				if (down) snap.down |= bit;
+				else snap.up |= bit;
+				bit <<= 1;
+#endif
+			}
+#if BUTTON_SNAPSHOT
+			bank->snapshot = snap;  // interrupts are off, so no reader can be part way through a copy
+#endif
+#if ISR_SLICE
+			bank->sliceNext = config->count;  // drop any part sampled period, it is started again on the next one
+#endif
+		}
+	}
+	
+	
+	// The out of line versions are always built, even with DEBOUNCE_INLINE, for code that wants their address.
+	// The brackets round the names stop the DEBOUNCE_INLINE macros changing them.
+	
 	uint8_t read_button(volatile uint8_t *port, uint8_t bit)
 	{
-		if ((*port & (1<<bit)) == 0) return 1; // (1<<bit) is to set the mask to all zeros except the bit in question. Single & as we are performing a logical "and", not a comparison)
-		else return 0;
+		return debounce_read(*port, bit); // the pin's bit shifted down to bit 0 and flipped, as the button is active low - no branch
 	}
 	
 
@@ -141,31 +767,210 @@ ISR(TIMER0_COMPA_vect)
 	}
 	
 	//Button state detection routines
-	uint8_t is_button_pressed(uint8_t *button_history)
+	uint8_t (is_button_pressed)(uint8_t *button_history)
 	{
-		return (*button_history == 0b00111111);
+		return (pgm_read_byte(&historyClass[*button_history]) & HISTORY_PRESSED) != 0;
 		//the source article looks for a button that might drop the signal for a few bits, and we look for the signal either side.  I don't want that so deleted the code.
 	}
 	
 	
-	uint8_t is_button_released(uint8_t *button_history)
+	uint8_t (is_button_released)(uint8_t *button_history)
 	{
-		return (*button_history == 0b11100000);
+		return (pgm_read_byte(&historyClass[*button_history]) & HISTORY_RELEASED) != 0;
 		//the source article looks for a button that might drop the signal for a few bits, and we look for the signal either side.  I don't want that so deleted the code.
 	}
 
 
-	uint8_t is_button_down(uint8_t *button_history)
+	uint8_t (is_button_down)(uint8_t *button_history)
+	{
+		return (pgm_read_byte(&historyClass[*button_history]) & HISTORY_DOWN) != 0;
+	}
+
+
+	uint8_t (is_button_up)(uint8_t *button_history)
 	{
-		return (*button_history == 0b11111111);
+		return (pgm_read_byte(&historyClass[*button_history]) & HISTORY_UP) != 0;
+	}
+
+	
+	// every state of the button in one go - HISTORY_DOWN, HISTORY_UP, HISTORY_PRESSED, HISTORY_RELEASED, HISTORY_BOUNCING
+	uint8_t (button_class)(uint8_t *button_history)
+	{
+		return pgm_read_byte(&historyClass[*button_history]);
 	}
 
 
-	uint8_t is_button_up(uint8_t *button_history)
+	uint8_t bank_button_class(DebounceBank *bank, uint8_t button)
 	{
-		return (*button_history == 0b00000000);
+		if (button >= bank->config->count) return 0;
+		return pgm_read_byte(&bank->config->classTable[bank->history[button]]);
 	}
 
 
+#if ISR_STATS
+	// copy the ISR timing figures out in one go so they all relate to the same moment
+	void get_isr_stats(IsrStats *stats)
+	{
+		uint32_t sum;
+		uint16_t ticks;
+		ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+		{
+			stats->minCycles = isrMin;
+			stats->maxCycles = isrMax;
+			stats->overruns = isrOverruns;
+			sum = isrLastSum;
+			ticks = isrLastTicks;
+		}
+		// the divisions are done here, with interrupts on, rather than in the ISR
+		if (ticks == 0)
+		{
+			stats->avgCycles = 0;  // the first window hasn't finished yet
+			stats->cpuLoad = 0;
+		} else
+		{
+			stats->avgCycles = sum / ticks;
+			// from the average rather than the sum - a whole window of long ISRs times 100 doesn't fit 32 bits
+			uint32_t load = ((uint32_t)stats->avgCycles * 100) / ISR_STATS_TICK_CYCLES;
+			stats->cpuLoad = (load > UINT8_MAX) ? UINT8_MAX : load;
+		}
+	}
 
 
+	void reset_isr_stats(void)
+	{
+		ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+		{
+			isrMin = UINT16_MAX;
+			isrMax = 0;
+			isrOverruns = 0;
+			isrWindowSum = 0;
+			isrWindowTicks = 0;
+			isrLastSum = 0;
+			isrLastTicks = 0;
+		}
+	}
+#endif
+
+
+#if LATENCY_HISTOGRAM
+	// copy one button's histogram out and start it again from zero
+	void dump_latency_histogram(DebounceBank *bank, uint8_t button, LatencyHistogram *hist)
+	{
+		if (button >= bank->config->count) return;
+		ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+		{
+			*hist = bank->state[button].latency;
+			bank->state[button].latency = (LatencyHistogram){{0}, {0}};
+		}
+	}
+
+
+	void reset_latency_histograms(DebounceBank *bank)
+	{
+		for (uint8_t i = 0; i < bank->config->count; i++)
+		{
+			LatencyHistogram discard;
+			dump_latency_histogram(bank, i, &discard);
+		}
+	}
+#endif
+
+
+#if BUTTON_SNAPSHOT
+	// all the bank's buttons as the ISR last saw them, without turning interrupts off
+	void get_button_snapshot(DebounceBank *bank, ButtonSnapshot *snap)
+	{
+		uint8_t seq;
+		do
+		{
+			seq = bank->snapshotSeq;
+			*snap = bank->snapshot;
+		} while ((seq & 0x01) || (seq != bank->snapshotSeq));
+	}
+#endif
+
+
+#if BOUNCE_STATS
+	void get_bounce_stats(DebounceBank *bank, uint8_t button, BounceStats *stats)
+	{
+		if (button >= bank->config->count) return;
+		ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+		{
+			*stats = bank->state[button].bounce;
+		}
+	}
+
+
+	void reset_bounce_stats(DebounceBank *bank, uint8_t button)
+	{
+		if (button >= bank->config->count) return;
+		ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+		{
+			bank->state[button].bounce = (BounceStats){0};
+		}
+	}
+#endif
+
+
+#if BUTTON_EVENTS
+	// take the oldest event off the queue - returns 1 if there was one
+	uint8_t get_button_event(ButtonEvent *event)
+	{
+		uint8_t tail = eventTail;
+		if (tail == eventHead) return 0;
+		*event = eventQueue[tail];
+		eventTail = (tail + 1) & (EVENT_QUEUE_SIZE - 1);
+		return 1;
+	}
+
+
+	// take up to max events off the queue in one go - returns how many were taken.  The ISR's head is read
+	// once, so events queued while copying wait for the next call
+	uint8_t get_button_events(ButtonEvent *events, uint8_t max)
+	{
+		uint8_t tail = eventTail;
+		uint8_t head = eventHead;
+		uint8_t taken = 0;
+		while ((tail != head) && (taken < max))
+		{
+			events[taken++] = eventQueue[tail];
+			tail = (tail + 1) & (EVENT_QUEUE_SIZE - 1);
+		}
+		eventTail = tail;
+		return taken;
+	}
+
+
+	// put an event in the queue from outside the debounce - from an ISR, or with interrupts off, as the queue has
+	// only one writer at a time
+	void queue_button_event(uint8_t button, uint8_t type)
+	{
+		push_event(button, type);
+	}
+
+
+	uint16_t get_button_event_drops(void)
+	{
+		uint16_t drops;
+		ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+		{
+			drops = eventDrops;
+		}
+		return drops;
+	}
+#endif
+
+
+#if BUTTON_CHORDS
+	// have the ISR watch for a chord on a bank
+	void add_chord(DebounceBank *bank, Chord *chord)
+	{
+		chord->state = 0;
+		chord->heldMs = 0;
+		ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+		{
+			chord->next = bank->chords;
+			bank->chords = chord;
+		}
+	}
+#endif
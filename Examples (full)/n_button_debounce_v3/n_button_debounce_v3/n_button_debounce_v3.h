@@ -15,14 +15,103 @@
  * Notes - 
  * 1 - setup a regular counter for 1ms ticks (ie the equivalent to Arduino Millis())
  * 2 - This version uses Timer 0 with a count value of 125 (0x7D) and prescale is 64 assuming 8MHz clock.
- * 3 - Update the button in the ISR of the 1ms timer, so the button gets tested every 5ms
+ * 3 - Update the button in the ISR of the 1ms timer, so the button gets tested every 1ms (the sample period in
+ *     defaultConfig - a bank can be sampled less often, eg every 5ms)
  * 4 - refer to button debounce algorithm https://hackaday.com/2015/12/10/embed-with-elliot-debounce-your-noisy-buttons-part-ii/#more-180185 for details how the debounce works
  * 5 - In this code below, 3 buttons are port D and last button is on port B
  * 6 - Note that the routine uses interrupts
+ * 7 - Set ISR_STATS to 1 to time the debounce ISR.  This takes over Timer 1 (free running at the CPU clock) so
+ *     the ISR length can be read in CPU cycles with get_isr_stats()
+ * 8 - Set LATENCY_HISTOGRAM to 1 to count, per button, how many samples each press and release took from the
+ *     first change seen on the pin to the debounced decision.  Read it with dump_latency_histogram()
+ * 9 - Set BUTTON_EVENTS to 1 to have the ISR queue a BUTTON_PRESSED or BUTTON_RELEASED event, with a
+ *     timestamp, each time a button's debounced state changes.  Take them off the queue with get_button_event(),
+ *     or a batch at a time with get_button_events().  dispatch.c calls handlers for them
+ * 10 - Set BOUNCE_STATS to 1 to count the bounces of each press and release and keep the longest and average
+ *     bounce time per button, to spot wearing switches.  Read them with get_bounce_stats()
+ * 11 - Set BUTTON_SNAPSHOT to 1 to have the ISR publish the down/up/pressed/released state of every button as
+ *     bit masks after each sample.  get_button_snapshot() reads them all at once, consistently, without cli/sei
+ * 12 - Set DEBOUNCE_INLINE to 1 to use the header only versions of the update and query routines in
+ *     n_button_debounce_v3_inline.h.  The ISR and every is_button_...() call are then compiled in place rather
+ *     than called.  It is not measured on the AVR yet - run Benchmark/bench.sh to compare.  On the PC it made no
+ *     clear difference (Benchmark/baseline_host.csv)
+ * 13 - The buttons are debounced in banks.  The buttons in btn[] are the default bank, defaultBank, which
+ *     start_debounce() sets going.  More banks, each with its own pins, sample period and debounce table, can be
+ *     added with add_debounce_bank() - the one timer tick services them all.  See DEBOUNCE_BANK() below.
+ * 14 - Set ENCODERS to 1 and add encoder.c to the project to decode quadrature rotary encoders on the same
+ *     timer tick, every 1ms.  See encoder.h
+ * 15 - Host builds only: set DEBOUNCE_TRACE to 1 and the ISR calls debounce_trace(bank), which your program
+ *     supplies, after sampling each bank - "Host tools/vcd_trace.h" shows one that writes a VCD for GTKWave
+ * 16 - add_debounce_bank() (and so start_debounce()) reads every pin once and starts each history as all 1's or
+ *     all 0's to match, so a button held at power on (service mode, factory reset) is down straight away, with
+ *     no pressed edge or event.  seed_debounce_bank() does it again, eg after waking from sleep.  Set
+ *     SEED_HISTORY to 0 for the old start from all 0's (up)
+ * 17 - The sample period of a bank can be changed while running with set_bank_sample_period().  Set
+ *     DEBOUNCE_PARAMS to 1 and add debounce_params.c to keep tuned values in EEPROM - start_debounce() loads them
+ * 18 - Set BUTTON_CHORDS (and BUTTON_EVENTS) to 1 to have the ISR watch for button combinations added with
+ *     add_chord() - eg buttons 0 and 3 held for 2 seconds.  They are checked a whole bank at a time against the
+ *     debounced state as one word, can insist which button goes first and that nothing else is held, and are
+ *     reported as BUTTON_CHORD and BUTTON_CHORD_END events in the same queue as the buttons:
+ *
+ *       const ChordConfig serviceConfig = {(1 << 0) | (1 << 3), 2000, CHORD_ANY_ORDER, 1, 20};
+ *       Chord service = {.config = &serviceConfig};
+ *       add_chord(&defaultBank, &service);
+ *       ...  if (e.type == BUTTON_CHORD && e.button == 20) enter_service_mode();
+ * 19 - Set PRIORITY_INPUTS to 1 and add priority_input.c to the project for inputs like an emergency stop that
+ *     can't wait for the history - they react on the first edge in INT0, INT1 or a pin change interrupt and the
+ *     tick then locks the bounces out.  See priority_input.h
+ * 20 - With a lot of buttons, sampling a whole bank in one ISR holds the other interrupts (UART, motor control)
+ *     off for a long time.  Set ISR_SLICE to the most buttons of a bank the tick may sample at once, and a bank is
+ *     sampled ISR_SLICE buttons a tick over the ticks of its sample period - each button is still sampled every
+ *     period, just not all on the same tick.  The bound is per bank, not for the tick as a whole - every bank
+ *     with a slice due samples up to ISR_SLICE of its own buttons, so the longest tick is ISR_SLICE buttons
+ *     times the number of banks (or the buttons of the smaller banks, where a bank has fewer).  A shared budget
+ *     would let one bank hold another's slices back past its period.  A bank needs count / ISR_SLICE (rounded
+ *     up) ms to get round its buttons, and its sample period is raised to that if it is shorter, eg 64 buttons
+ *     every 5ms needs ISR_SLICE of 13 or more.
+ *     A later slice reads its pins a few ms after the first, so two buttons that change together can be seen a
+ *     sample period apart, which can move a chord's start or end by a period
+ * 21 - Set DEBOUNCE_NOBLOCK to 1 and the timer ISR only counts the ms, does the encoders and priority lockouts,
+ *     and copies PINB, PINC and PIND with interrupts off.  It then turns interrupts back on to sample the banks
+ *     from that copy, so the UART or motor control interrupts only wait for the short part.  A tick that comes in
+ *     while the banks of the last one are still being done is caught up straight after, never run on top of it.
+ *     Buttons on other ports are read when their bank gets sampled.
+ *     The cost is stack.  While the banks are sampled one more interrupt can be stacked on top of the tick - at
+ *     most one, as AVR interrupts start with interrupts off: either another of your ISRs (as deep as its own
+ *     calls go), or the next tick, which only does the encoders, lockouts and ms count and leaves.  Neither can
+ *     be interrupted in turn unless that ISR turns interrupts on itself.  So the worst case stack is the tick
+ *     down to the deepest bank sampling call, plus the deepest of your ISRs or of a tick that stops early.  Each
+ *     ISR that calls functions takes 17 bytes just to start (its return address, SREG, r0, r1 and the 12 other
+ *     registers a call may change), on top of its own locals.  Build with -fstack-usage to see the rest - it
+ *     hasn't been measured yet, nor has the latency it saves (bench.sh latency)
+ * 22 - Set BUTTON_MODES to 1 to mix active high inputs in with the buttons.  Each Buttons entry gets a fifth
+ *     field, mode - BUTTON_ACTIVE_HIGH for an input that goes high when it is on, BUTTON_NO_PULL to leave the
+ *     pull up off.  Left out it is 0, the usual active low button with the pull up, so existing tables still
+ *     work.  An active high input never gets the pull up, with or without BUTTON_NO_PULL - the pull up would
+ *     hold the pin high, so it would read as pressed whenever nothing pulled it down.  Give it a pull down
+ *     resistor if it can float.  When the bank is added the modes are made into one XOR mask per port (ports
+ *     other than B, C and D share one), so the tick XORs each port word it reads once and takes the buttons'
+ *     bits out of that - keep each port's buttons together in the table and each port is read once.  Eg:
+ *
+ *       {0x02, (uint8_t*)0x26, (uint8_t*)0x28, (uint8_t*)0x27, BUTTON_ACTIVE_HIGH}  // sensor on C2
+ * 23 - Set FLIGHT_RECORDER to 1 and add flight_recorder.c to the project to keep the last raw samples of a bank,
+ *     run length encoded, and freeze them when a ghost press happens so there is something to look at when one
+ *     is reported.  "Host tools/flight_replay.c" replays a dump.  See flight_recorder.h
  *
  * To use these routines for debouncing switches set the number of switches (n) and what ports they are    
  * connected in the implementation "c" file.
  *
+ * A second bank, eg three buttons on port C sampled every 2ms with a different debounce table:
+ *
+ *   const Buttons panelPins[3] = {{0, &PINC, &PORTC, &DDRC}, {1, &PINC, &PORTC, &DDRC}, {2, &PINC, &PORTC, &DDRC}};
+ *   const uint8_t panelTable[256] PROGMEM = { HISTORY_TABLE(MY_CLASSIFY) };   // see history_lut.h
+ *   const DebounceBankConfig panelConfig = {panelPins, 3, 2, 8, panelTable};  // events numbered from 8
+ *   DEBOUNCE_BANK(panel, panelConfig, 3);
+ *   ...
+ *   start_debounce();
+ *   add_debounce_bank(&panel);
+ *   if (bank_button_class(&panel, 0) & HISTORY_DOWN) ...
+ *
  *
  *
  *
@@ -31,24 +120,314 @@
  #ifndef NBUTTONDEBOUNCE_v3_H
  #define NBUTTONDEBOUNCE_v3_H
 
+#include <stdint.h>
+#include "history_lut.h"
+
 //defines
-#define n 4 //4 buttons are installed
+#ifndef n
+#define n 4 //4 buttons are installed in the default bank
+#endif
+#ifndef MAX_BANK_BUTTONS
+#define MAX_BANK_BUTTONS n // the most buttons any bank has - sets the size of the snapshot masks
+#endif
+
+//Options - set to 1 here or in the compiler symbols to switch them on
+#ifndef ISR_STATS
+#define ISR_STATS 0 // time the debounce ISR using Timer 1
+#endif
+#ifndef LATENCY_HISTOGRAM
+#define LATENCY_HISTOGRAM 0 // keep a press/release latency histogram per button
+#endif
+#ifndef BUTTON_EVENTS
+#define BUTTON_EVENTS 0 // queue press and release events for the main loop
+#endif
+#ifndef BOUNCE_STATS
+#define BOUNCE_STATS 0 // count contact bounce per button
+#endif
+#ifndef BUTTON_SNAPSHOT
+#define BUTTON_SNAPSHOT 0 // publish all the button states as bit masks
+#endif
+#ifndef DEBOUNCE_INLINE
+#define DEBOUNCE_INLINE 0 // inline the update and query routines
+#endif
+#ifndef ENCODERS
+#define ENCODERS 0 // sample the rotary encoders in encoder.c
+#endif
+#ifndef DEBOUNCE_TRACE
+#define DEBOUNCE_TRACE 0 // host builds - call debounce_trace() after each bank is sampled
+#endif
+#ifndef SEED_HISTORY
+#define SEED_HISTORY 1 // start each history from the pin level when the bank is added
+#endif
+#define SEED_SETTLE_US 10 // time for the pull ups to charge the pins before they are read
+#ifndef DEBOUNCE_PARAMS
+#define DEBOUNCE_PARAMS 0 // load tuned parameters from EEPROM, see debounce_params.h
+#endif
+#ifndef BUTTON_CHORDS
+#define BUTTON_CHORDS 0 // report button combinations as events - needs BUTTON_EVENTS
+#endif
+#ifndef PRIORITY_INPUTS
+#define PRIORITY_INPUTS 0 // react to the inputs in priority_input.c on their first edge
+#endif
+#ifndef ISR_SLICE
+#define ISR_SLICE 0 // the most buttons of each bank the tick samples at once, 0 for the whole bank in one tick
+#endif
+#ifndef DEBOUNCE_NOBLOCK
+#define DEBOUNCE_NOBLOCK 0 // sample the banks with interrupts back on, so other ISRs aren't held up
+#endif
+#ifndef BUTTON_MODES
+#define BUTTON_MODES 0 // give each button a mode - active high or low, pull up on or off
+#endif
+#ifndef FLIGHT_RECORDER
+#define FLIGHT_RECORDER 0 // keep the last raw samples of a bank for diagnosing ghost presses, see flight_recorder.h
+#endif
+#if BUTTON_CHORDS && !BUTTON_EVENTS
+#error "BUTTON_CHORDS needs BUTTON_EVENTS set to 1"
+#endif
+
+#define EDGE_TRACKING (LATENCY_HISTOGRAM || BOUNCE_STATS)  // options that follow each change from its first edge
+#define BUTTON_DECISIONS (EDGE_TRACKING || BUTTON_EVENTS || DEBOUNCE_TRACE)  // options that need the debounced state tracked in the ISR
+
+//event types
+#define BUTTON_PRESSED 1
+#define BUTTON_RELEASED 2
+#define BUTTON_CHORD 3      // a chord has been held for its hold time
+#define BUTTON_CHORD_END 4  // a chord that fired has been let go
+
+
+#if ISR_STATS
+typedef struct
+{
+	uint16_t minCycles;  // shortest ISR seen, in CPU cycles (0xFFFF until the first tick)
+	uint16_t maxCycles;  // longest ISR seen
+	uint16_t avgCycles;  // average over the last complete 1 second window
+	uint16_t overruns;   // number of ISRs that ran into the next 1ms tick (stops at 0xFFFF)
+	uint8_t cpuLoad;     // percentage of the CPU used by the ISR over the last complete 1 second window, 255 at most
+} IsrStats;
+#endif
+
+#if LATENCY_HISTOGRAM
+#define LATENCY_BUCKETS 6  // bucket 0 is 0-1 samples, 1 is 2-3, 2 is 4-7 ... the last one takes everything longer
+typedef struct
+{
+	uint8_t press[LATENCY_BUCKETS];    // number of presses in each bucket (stops at 255)
+	uint8_t release[LATENCY_BUCKETS];  // number of releases in each bucket
+} LatencyHistogram;
+#endif
+
+#if BOUNCE_STATS
+typedef struct
+{
+	uint16_t changes;         // presses and releases measured (all these counts stop at their maximum)
+	uint16_t bounces;         // total extra pin changes over all of them
+	uint8_t lastBounces;      // extra pin changes in the latest press or release
+	uint8_t maxBounceTime;    // longest time from the first edge to the last bounce, in samples
+	uint16_t meanBounceTime;  // running average of that time over about the last 8, in 1/16ths of a sample
+} BounceStats;
+#endif
+
+#if BUTTON_SNAPSHOT || BUTTON_CHORDS || FLIGHT_RECORDER
+// one bit per button, bit 0 is the bank's first button
+#if MAX_BANK_BUTTONS <= 8
+typedef uint8_t ButtonMask;
+#elif MAX_BANK_BUTTONS <= 16
+typedef uint16_t ButtonMask;
+#else
+typedef uint32_t ButtonMask;
+#endif
+#endif
+
+#if BUTTON_SNAPSHOT
+typedef struct
+{
+	ButtonMask down;      // the same as is_button_down() for each button
+	ButtonMask up;        // is_button_up()
+	ButtonMask pressed;   // is_button_pressed()
+	ButtonMask released;  // is_button_released()
+} ButtonSnapshot;
+#endif
+
+#if BUTTON_EVENTS
+#define EVENT_QUEUE_SIZE 16  // must be a power of 2, holds one less than this
+typedef struct
+{
+	uint8_t button;  // the bank's firstId plus the button's place in the bank
+	uint8_t type;    // BUTTON_PRESSED, BUTTON_RELEASED, BUTTON_CHORD or BUTTON_CHORD_END
+	uint16_t time;   // bottom 16 bits of milliCtr when the event was decided
+} ButtonEvent;
+#endif
+
 
+// where a button is connected
+typedef struct
+{
+	uint8_t terminal;   // the actual pin the button is connected to
+	volatile uint8_t *inputPort;  // the port to be read for that button	
+	volatile uint8_t *outputPort; // the port to write to if setting up internal pullup resistors
+	volatile uint8_t *ddr;
+#if BUTTON_MODES
+	uint8_t mode;       // BUTTON_ACTIVE_HIGH and/or BUTTON_NO_PULL, 0 (or left out) for active low with the pull up
+#endif
+} Buttons;
 
-//Global variables
-volatile uint64_t milliCtr;
-volatile uint64_t startCnt;  //dont set these to 0 to ensure the compiler puts the variables in the .BSS section of the code (see Lib-c manual)
-uint8_t button_history[n];
+// what a bank is - this can be const
+typedef struct
+{
+	const Buttons *buttons;      // the pins, count of them
+	uint8_t count;               // up to MAX_BANK_BUTTONS
+	uint8_t samplePeriod;        // ms between samples
+	uint8_t firstId;             // the number the first button gets in events, so banks don't clash
+	const uint8_t *classTable;   // the debounce algorithm - a 256 entry history_lut.h table in flash
+} DebounceBankConfig;
+
+#if BUTTON_DECISIONS
+// the per button working state the options need, on top of the history
+typedef struct
+{
+	uint8_t down;               // debounced state, moved on by the press and release decisions
+#if EDGE_TRACKING
+	uint8_t edgeAge;            // samples since the first edge of a change plus 1, 0 when no change is in progress
+#endif
+#if LATENCY_HISTOGRAM
+	LatencyHistogram latency;
+#endif
+#if BOUNCE_STATS
+	uint8_t bounceChanges;      // pin changes seen so far in this press or release
+	uint8_t bounceLastAge;      // edge age at the last of them
+	BounceStats bounce;
+#endif
+} ButtonState;
+#endif
+
+// a bank's working state - use DEBOUNCE_BANK() to make one with its storage
+#if BUTTON_CHORDS
+#define CHORD_ANY_ORDER 0xFF
+typedef struct
+{
+	ButtonMask mask;    // the buttons in the chord, as bits of the bank
+	uint16_t holdMs;    // how long they must all be held together before it fires, 0 for straight away
+	uint8_t first;      // the bank button that must go down before the others, or CHORD_ANY_ORDER
+	uint8_t exact;      // 1 if no other button of the bank may be down as well
+	uint8_t id;         // the button number the chord's events carry - keep it clear of the real buttons
+} ChordConfig;
+
+typedef struct Chord
+{
+	const ChordConfig *config;
+	uint16_t heldMs;    // how long the whole chord has been held
+	uint8_t state;
+	struct Chord *next; // the next chord on the same bank
+} Chord;
+#endif
+
+typedef struct DebounceBank
+{
+	const DebounceBankConfig *config;
+	uint8_t *history;            // the button histories, config->count of them
+#if BUTTON_DECISIONS
+	ButtonState *state;          // config->count of them
+#endif
+	uint8_t samplePeriod;        // ms between samples - config->samplePeriod unless changed at run time
+	uint8_t divider;             // ms to the next sample
+	uint8_t slot;                // the order the bank was added in, defaultBank is 0
+#if BUTTON_MODES
+	uint8_t polarity[4];         // what to XOR PINB, PINC, PIND and any other port with - 0xFF but for its active high inputs
+#endif
+#if BUTTON_SNAPSHOT
+	volatile uint8_t snapshotSeq;  // odd while the ISR is writing the snapshot
+	volatile ButtonSnapshot snapshot;
+#endif
+#if BUTTON_CHORDS
+	Chord *chords;               // added with add_chord()
+#endif
+#if ISR_SLICE
+	uint8_t sliceNext;           // the next button to sample this period, config->count once they all have been
+#if BUTTON_SNAPSHOT
+	ButtonSnapshot sliceSnap;    // the snapshot so far, built up a slice at a time
+#endif
+#if BUTTON_CHORDS
+	ButtonMask sliceDown;        // and the debounced state for the chords
+#endif
+#endif
+	struct DebounceBank *next;   // the next bank the tick services
+} DebounceBank;
+
+#if BUTTON_DECISIONS
+#define DEBOUNCE_BANK(name, bankConfig, buttonCount) \
+	static uint8_t name##History[buttonCount]; \
+	static ButtonState name##State[buttonCount]; \
+	DebounceBank name = {.config = &(bankConfig), .history = name##History, .state = name##State}
+#else
+#define DEBOUNCE_BANK(name, bankConfig, buttonCount) \
+	static uint8_t name##History[buttonCount]; \
+	DebounceBank name = {.config = &(bankConfig), .history = name##History}
+#endif
+
+
+//Global variables - these live in n_button_debounce_v3.c
+extern volatile uint64_t milliCtr;
+extern volatile uint64_t startCnt;
+extern uint8_t button_history[n];  // the histories of the default bank, btn[0] to btn[n-1]
+extern DebounceBank defaultBank;
+extern const uint8_t historyClass[256] PROGMEM;  // the table for the v3 debounce rules
 
 
 
 //prototype functions
 void start_debounce(void);
+void add_debounce_bank(DebounceBank *bank);  // does nothing if the bank has already been added
+void seed_debounce_bank(DebounceBank *bank);
+void set_bank_sample_period(DebounceBank *bank, uint8_t ms);
 void update_button(uint8_t *button_history, volatile uint8_t *button_port, uint8_t button_bit);
 uint8_t read_button(volatile uint8_t *port, uint8_t bit);
 uint8_t is_button_pressed(uint8_t *button_history);
 uint8_t is_button_released(uint8_t *button_history);
 uint8_t is_button_down(uint8_t *button_history);
 uint8_t is_button_up(uint8_t *button_history);
+uint8_t button_class(uint8_t *button_history);  // the HISTORY_ bits from history_lut.h
+uint8_t bank_button_class(DebounceBank *bank, uint8_t button);  // the same for any bank, using its own table
+
+#if DEBOUNCE_INLINE
+// The ISR writes button_history, so read it as volatile here or the compiler could keep a stale copy in a loop
+#include "n_button_debounce_v3_inline.h"
+#define is_button_pressed(history) history_is_pressed(*(volatile uint8_t *)(history))
+#define is_button_released(history) history_is_released(*(volatile uint8_t *)(history))
+#define is_button_down(history) history_is_down(*(volatile uint8_t *)(history))
+#define is_button_up(history) history_is_up(*(volatile uint8_t *)(history))
+#endif
+
+#if ISR_STATS
+void get_isr_stats(IsrStats *stats);
+void reset_isr_stats(void);
+#endif
+
+#if LATENCY_HISTOGRAM
+void dump_latency_histogram(DebounceBank *bank, uint8_t button, LatencyHistogram *hist);
+void reset_latency_histograms(DebounceBank *bank);
+#endif
+
+#if BOUNCE_STATS
+void get_bounce_stats(DebounceBank *bank, uint8_t button, BounceStats *stats);
+void reset_bounce_stats(DebounceBank *bank, uint8_t button);
+#endif
+
+#if BUTTON_SNAPSHOT
+void get_button_snapshot(DebounceBank *bank, ButtonSnapshot *snap);
+#endif
+
+#if DEBOUNCE_TRACE
+void debounce_trace(const DebounceBank *bank);  // not in the library - the host program supplies it
+#endif
+
+#if BUTTON_EVENTS
+uint8_t get_button_event(ButtonEvent *event);
+uint8_t get_button_events(ButtonEvent *events, uint8_t max);
+uint16_t get_button_event_drops(void);
+void queue_button_event(uint8_t button, uint8_t type);  // from an ISR, or with interrupts off
+#endif
+
+#if BUTTON_CHORDS
+void add_chord(DebounceBank *bank, Chord *chord);
+#endif
 
 #endif //NBUTTONDEBOUNCE_v3_H
\ No newline at end of file
@@ -0,0 +1,102 @@
+/*************************************************************************************************************
+ * n_button_debounce_v3_inline.h - header only versions of the button update and query routines
+ *
+ * Created: 19/10/2026
+ * Author : agent
+ *
+ * These are "static inline" so the compiler can put the code straight into the caller instead of calling a
+ * function with a pointer for each check.  Whether that comes out smaller or faster on the AVR depends on the
+ * compiler and how many places call them - it hasn't been measured on the AVR yet (Benchmark/bench.sh builds
+ * both ways).  Built for the PC ("bench.sh host", Benchmark/baseline_host.csv) it made no clear difference:
+ * the library object was 1 byte bigger and the main loop queries took about as long.  They work on the history
+ * byte itself, and use nothing from the AVR headers, so the host tools can use them too and get exactly the
+ * same debounce.
+ *
+ * The library uses them itself when DEBOUNCE_INLINE is 1 (see n_button_debounce_v3.h), and then
+ * is_button_pressed() etc become macros that call them, so existing code needs no changes.
+ *
+ * The debounce rules are here as well - a press is decided when (history & PRESSED_MASK) == PRESSED_PATTERN
+ * and a release when (history & RELEASED_MASK) == RELEASED_PATTERN.  Change them here, or in the compiler
+ * symbols, and the classification table in n_button_debounce_v3.c and every query follow.  Each of the four
+ * can be set on its own - the ones left out keep their defaults.
+ *
+ ************************************************************************************************************/
+#ifndef NBUTTONDEBOUNCE_v3_INLINE_H
+#define NBUTTONDEBOUNCE_v3_INLINE_H
+
+#include <stdint.h>
+
+//the debounce rules
+#ifndef PRESSED_MASK
+#define PRESSED_MASK 0b11111111
+#endif
+#ifndef PRESSED_PATTERN
+#define PRESSED_PATTERN 0b00111111
+#endif
+#ifndef RELEASED_MASK
+#define RELEASED_MASK 0b11111111
+#endif
+#ifndef RELEASED_PATTERN
+#define RELEASED_PATTERN 0b11100000
+#endif
+
+
+//button modes (the mode of a button, with BUTTON_MODES) - 0 is the usual active low button with the pull up on
+#define BUTTON_ACTIVE_LOW 0x00   // pressing it pulls the pin to 0V
+#define BUTTON_ACTIVE_HIGH 0x01  // pressing it drives the pin high, eg a sensor output - the pull up is left off
+#define BUTTON_PULL_UP 0x00      // the internal pull up is turned on (active low inputs only)
+#define BUTTON_NO_PULL 0x02      // the pull up is left off - the pin is driven, or has its own resistor
+
+
+// 1 if the input's pull up should be on.  Never for an active high input - the pull up would hold its pin high,
+// ie pressed, whenever nothing drives it low
+static inline uint8_t debounce_pull_up(uint8_t mode)
+{
+	return !(mode & (BUTTON_ACTIVE_HIGH | BUTTON_NO_PULL));
+}
+
+// 1 if the button is pressed - the buttons are active low with the pull up on
+static inline uint8_t debounce_read(uint8_t pins, uint8_t bit)
+{
+	return ((pins >> bit) & 0x01) ^ 0x01;
+}
+
+// what to XOR a port with so that a pressed button's bit reads 1 - 0xFF for active low, 0x00 for active high
+static inline uint8_t debounce_polarity(uint8_t mode)
+{
+	return (uint8_t)((mode & BUTTON_ACTIVE_HIGH) - 1);
+}
+
+// 1 if the button is pressed, for either polarity - an XOR of the whole port then a shift and AND, no branches
+static inline uint8_t debounce_read_polarity(uint8_t pins, uint8_t polarity, uint8_t bit)
+{
+	return ((pins ^ polarity) >> bit) & 0x01;
+}
+
+// shift the latest sample (1 = pressed) into the history
+static inline uint8_t debounce_shift(uint8_t history, uint8_t sample)
+{
+	return (uint8_t)(history << 1) | sample;
+}
+
+static inline uint8_t history_is_pressed(uint8_t history)
+{
+	return (history & PRESSED_MASK) == PRESSED_PATTERN;
+}
+
+static inline uint8_t history_is_released(uint8_t history)
+{
+	return (history & RELEASED_MASK) == RELEASED_PATTERN;
+}
+
+static inline uint8_t history_is_down(uint8_t history)
+{
+	return history == 0xFF;
+}
+
+static inline uint8_t history_is_up(uint8_t history)
+{
+	return history == 0x00;
+}
+
+#endif //NBUTTONDEBOUNCE_v3_INLINE_H
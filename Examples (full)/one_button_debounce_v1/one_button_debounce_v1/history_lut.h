@@ -0,0 +1,45 @@
+/****************************************************
+ * history_lut.h									*
+ *													*
+ * Created: 19/10/2026								*
+ *  Author: agent									*
+ *													*
+ * Builds a 256 entry table, at compile time, that	*
+ * gives every state of a button history byte in	*
+ * one read.  There is no C implementation file		*
+ ***************************************************/
+
+#ifndef HISTORY_LUT_H
+#define HISTORY_LUT_H
+
+#ifdef __AVR__
+#include <avr/pgmspace.h>
+#else
+// host builds - the table is an ordinary const array
+#define PROGMEM
+#define pgm_read_byte(address) (*(const uint8_t *)(address))
+#endif
+
+//the state bits in each table entry
+#define HISTORY_DOWN     0x01  // all 1's - the button is down
+#define HISTORY_UP       0x02  // all 0's - the button is up
+#define HISTORY_PRESSED  0x04  // the press is decided on this sample (the rising edge)
+#define HISTORY_RELEASED 0x08  // the release is decided on this sample (the falling edge)
+#define HISTORY_BOUNCING 0x10  // a mix of 1's and 0's - the button is changing or bouncing
+
+// The entry for history h, where the press is (h & pressedMask) == pressedPattern and the release is
+// (h & releasedMask) == releasedPattern.  An algorithm with different rules can make its own macro.
+#define HISTORY_CLASSIFY(h, pressedMask, pressedPattern, releasedMask, releasedPattern) \
+	( (((h) == 0xFF) ? HISTORY_DOWN : 0) \
+	| (((h) == 0x00) ? HISTORY_UP : 0) \
+	| ((((h) & (pressedMask)) == (pressedPattern)) ? HISTORY_PRESSED : 0) \
+	| ((((h) & (releasedMask)) == (releasedPattern)) ? HISTORY_RELEASED : 0) \
+	| ((((h) != 0xFF) && ((h) != 0x00)) ? HISTORY_BOUNCING : 0) )
+
+// HISTORY_TABLE(c) expands to the 256 initialisers c(0), c(1) ... c(255), where c is a classify macro taking h
+#define HISTORY_TABLE_4(c, h) c(h), c((h) + 1), c((h) + 2), c((h) + 3)
+#define HISTORY_TABLE_16(c, h) HISTORY_TABLE_4(c, h), HISTORY_TABLE_4(c, (h) + 4), HISTORY_TABLE_4(c, (h) + 8), HISTORY_TABLE_4(c, (h) + 12)
+#define HISTORY_TABLE_64(c, h) HISTORY_TABLE_16(c, h), HISTORY_TABLE_16(c, (h) + 16), HISTORY_TABLE_16(c, (h) + 32), HISTORY_TABLE_16(c, (h) + 48)
+#define HISTORY_TABLE(c) HISTORY_TABLE_64(c, 0), HISTORY_TABLE_64(c, 64), HISTORY_TABLE_64(c, 128), HISTORY_TABLE_64(c, 192)
+
+#endif /* HISTORY_LUT_H */
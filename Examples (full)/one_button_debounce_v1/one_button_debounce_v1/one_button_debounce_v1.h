@@ -40,9 +40,10 @@ void start_oneButtonDebounce(void);
 void update_button(uint8_t *button_history);
 uint8_t read_button(uint8_t byte, uint8_t bit);
 uint8_t is_button_pressed(uint8_t *button_history);
-uint8_t is_button_released(uint8_t *button_history);
+uint8_t is_button_released(uint8_t *button_history);  // clears the history when it returns 1 - see the .c file
 uint8_t is_button_down(uint8_t *button_history);
 uint8_t is_button_up(uint8_t *button_history);
+uint8_t button_class(uint8_t *button_history);  // the HISTORY_ bits from history_lut.h
 	
 	
 	
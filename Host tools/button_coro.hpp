@@ -0,0 +1,305 @@
+/*********************************************************************
+ * button_coro.hpp - C++20 coroutines that wait for buttons, for host builds
+ *
+ * Created: 19/10/2026
+ * Author : agent
+ *
+ * The host version of "Library files/n_button_V3/button_thread.h".  A ButtonTask is a coroutine that can
+ * co_await a press or release, with or without a time limit, fed from the library's event queue:
+ *
+ *   debounce::ButtonTask unlock_sequence()
+ *   {
+ *       for (;;)
+ *       {
+ *           co_await debounce::await_press(0);
+ *           bool inTime = co_await debounce::await_press(1, 500);   // false if 500ms passed first
+ *           if (inTime) unlock();
+ *       }
+ *   }
+ *
+ *   auto task = unlock_sequence();
+ *   while (running)
+ *   {
+ *       ButtonEvent e;
+ *       while (get_button_event(&e)) debounce::button_loop().post(e);   // every waiting task sees every event
+ *       debounce::button_loop().advance(milliCtr);                       // and the time, for the time limits
+ *   }
+ *
+ * Nothing uses the heap: the coroutine frames come from a fixed pool (BUTTON_CORO_FRAMES frames of
+ * BUTTON_CORO_FRAME_SIZE bytes - a task that doesn't fit comes back empty, see ButtonTask::valid()) and a
+ * waiting task is linked into the loop through a Waiter in its own frame.  An event a task waited for is
+ * used up in that task, so two co_awaits in a row need two events.  sleep_ms(0) doesn't wait at all.
+ *
+ * Build with -std=c++20 (g++ 10 or later, clang 14 or later).  g++ 12.2 gets a co_await used straight in
+ * an if () inside a loop wrong - the task crashes when it is resumed - and the header can't see that
+ * pattern in your code, so it refuses to build with g++ 12 at all.  If every co_await result in your tasks
+ * goes into a variable first, as above, define BUTTON_CORO_GCC12_OK to build anyway.  Other 12.x releases
+ * haven't been checked, so they are refused too.
+ *
+ **********************************************************************/
+
+#ifndef BUTTON_CORO_HPP
+#define BUTTON_CORO_HPP
+
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <utility>
+
+#if defined(__GNUC__) && !defined(__clang__) && (__GNUC__ == 12) && !defined(BUTTON_CORO_GCC12_OK)
+#error "g++ 12 miscompiles co_await straight inside if () in a loop - use another compiler, or put each co_await result in a variable and define BUTTON_CORO_GCC12_OK"
+#endif
+
+#ifndef BUTTON_CORO_FRAMES
+#define BUTTON_CORO_FRAMES 8
+#endif
+#ifndef BUTTON_CORO_FRAME_SIZE
+#define BUTTON_CORO_FRAME_SIZE 512
+#endif
+
+namespace debounce
+{
+
+// these match n_button_debounce_v3.h
+constexpr uint8_t BUTTON_PRESSED = 1;
+constexpr uint8_t BUTTON_RELEASED = 2;
+constexpr uint8_t NO_BUTTON = 0xFF;  // never matches, for sleep_ms()
+
+// fixed size blocks for the coroutine frames
+class FramePool
+{
+public:
+	void *allocate(std::size_t size) noexcept
+	{
+		if (size > BUTTON_CORO_FRAME_SIZE) return nullptr;
+		for (std::size_t i = 0; i < BUTTON_CORO_FRAMES; i++)
+		{
+			if (!used[i])
+			{
+				used[i] = true;
+				return frames[i];
+			}
+		}
+		return nullptr;
+	}
+
+	void release(void *frame) noexcept
+	{
+		for (std::size_t i = 0; i < BUTTON_CORO_FRAMES; i++)
+		{
+			if (frame == frames[i]) used[i] = false;
+		}
+	}
+
+private:
+	alignas(std::max_align_t) unsigned char frames[BUTTON_CORO_FRAMES][BUTTON_CORO_FRAME_SIZE];
+	bool used[BUTTON_CORO_FRAMES] = {};
+};
+
+inline FramePool &frame_pool()
+{
+	static FramePool pool;
+	return pool;
+}
+
+
+// a task waiting for an event - lives in the task's own coroutine frame, in its promise
+struct Waiter
+{
+	uint8_t button;
+	uint8_t type;
+	uint32_t timeout;   // ms, if hasDeadline
+	uint32_t start;
+	uint32_t pass = 0;  // the loop's pass that has already looked at it
+	bool hasDeadline = false;
+	bool timedOut = false;
+	bool linked = false;
+	std::coroutine_handle<> handle;
+	Waiter *next = nullptr;
+};
+
+
+class ButtonLoop
+{
+public:
+	// hand an event (a ButtonEvent, or anything with button and type members) to the waiting tasks
+	template <class Event>
+	void post(const Event &event)
+	{
+		resume_if([&](const Waiter &w) { return (w.button == event.button) && (w.type == event.type); }, false);
+	}
+
+	// move the time on (eg to milliCtr) and wake the tasks whose time limit has run out
+	void advance(uint32_t nowMs)
+	{
+		now = nowMs;
+		resume_if([&](const Waiter &w) { return w.hasDeadline && (now - w.start >= w.timeout); }, true);
+	}
+
+	uint32_t time() const { return now; }
+
+	void wait(Waiter *w)  // at the end, so the tasks are resumed in the order they waited
+	{
+		Waiter **p = &waiting;
+		while (*p) p = &(*p)->next;
+		w->start = now;
+		w->pass = pass;  // a task that waits again while the loop is resuming isn't looked at again this pass
+		w->linked = true;
+		w->next = nullptr;
+		*p = w;
+	}
+
+	void forget(Waiter *w)  // a task destroyed while it waits
+	{
+		for (Waiter **p = &waiting; *p; p = &(*p)->next)
+		{
+			if (*p == w)
+			{
+				*p = w->next;
+				break;
+			}
+		}
+		w->linked = false;
+	}
+
+private:
+	// A resumed task can wait again, finish, or destroy other tasks (which forget() takes off the list), so
+	// no pointer into the list is kept across a resume - the walk starts again from the front after each one.
+	// Each waiter is marked with the pass as it is looked at, so none is looked at twice and a task that waits
+	// again can't be handed the same event twice.
+	template <class Match>
+	void resume_if(Match match, bool timedOut)
+	{
+		uint32_t thisPass = ++pass;
+		Waiter **p = &waiting;
+		while (*p)
+		{
+			Waiter *w = *p;
+			if (w->pass == thisPass || !match(*w))
+			{
+				w->pass = thisPass;
+				p = &w->next;
+				continue;
+			}
+			*p = w->next;
+			w->linked = false;
+			w->timedOut = timedOut;
+			w->handle.resume();
+			p = &waiting;
+		}
+	}
+
+	Waiter *waiting = nullptr;
+	uint32_t now = 0;
+	uint32_t pass = 0;
+};
+
+inline ButtonLoop &button_loop()
+{
+	static ButtonLoop loop;
+	return loop;
+}
+
+
+// the coroutine type - runs straight away up to its first co_await, and is destroyed with the ButtonTask
+class ButtonTask
+{
+public:
+	struct promise_type
+	{
+		Waiter waiter;  // a task waits for one thing at a time, so its frame holds the loop's link to it
+		ButtonLoop *loop = nullptr;
+
+		~promise_type()
+		{
+			if (waiter.linked) loop->forget(&waiter);  // destroyed while it waits
+		}
+		ButtonTask get_return_object() { return ButtonTask(std::coroutine_handle<promise_type>::from_promise(*this)); }
+		static ButtonTask get_return_object_on_allocation_failure() { return ButtonTask(); }
+		std::suspend_never initial_suspend() noexcept { return {}; }
+		std::suspend_always final_suspend() noexcept { return {}; }
+		void return_void() {}
+		void unhandled_exception() { std::terminate(); }
+		static void *operator new(std::size_t size) noexcept { return frame_pool().allocate(size); }
+		static void operator delete(void *frame) noexcept { frame_pool().release(frame); }
+	};
+
+	ButtonTask() = default;
+	ButtonTask(ButtonTask &&other) noexcept : handle(std::exchange(other.handle, {})) {}
+	ButtonTask &operator=(ButtonTask &&other) noexcept
+	{
+		if (this != &other)
+		{
+			if (handle) handle.destroy();
+			handle = std::exchange(other.handle, {});
+		}
+		return *this;
+	}
+	~ButtonTask()
+	{
+		if (handle) handle.destroy();
+	}
+
+	bool valid() const { return static_cast<bool>(handle); }  // false if the frame pool was full
+	bool done() const { return !handle || handle.done(); }
+
+private:
+	explicit ButtonTask(std::coroutine_handle<promise_type> h) : handle(h) {}
+	std::coroutine_handle<promise_type> handle;
+};
+
+
+// co_await one of these in a ButtonTask - gives true for the event, false if the time limit ran out first
+class EventAwaiter
+{
+public:
+	EventAwaiter(ButtonLoop &loop, uint8_t button, uint8_t type, uint32_t timeout, bool hasDeadline)
+		: loop(loop), button(button), type(type), timeout(timeout), hasDeadline(hasDeadline) {}
+
+	// a time limit of 0 has run out already, so there is nothing to wait for
+	bool await_ready() const noexcept { return hasDeadline && (timeout == 0); }
+	void await_suspend(std::coroutine_handle<ButtonTask::promise_type> h) noexcept
+	{
+		Waiter &w = h.promise().waiter;
+		task = h;
+		h.promise().loop = &loop;
+		w.button = button;
+		w.type = type;
+		w.timeout = timeout;
+		w.hasDeadline = hasDeadline;
+		w.timedOut = false;
+		w.handle = h;
+		loop.wait(&w);
+	}
+	bool await_resume() const noexcept { return task && !task.promise().waiter.timedOut; }  // false if it never waited
+
+private:
+	ButtonLoop &loop;
+	uint8_t button;
+	uint8_t type;
+	uint32_t timeout;
+	bool hasDeadline;
+	std::coroutine_handle<ButtonTask::promise_type> task;
+};
+
+// the timeout is in ms, 0 (or left out) to wait for as long as it takes
+inline EventAwaiter await_press(uint8_t button, uint32_t timeout = 0)
+{
+	return EventAwaiter(button_loop(), button, BUTTON_PRESSED, timeout, timeout != 0);
+}
+
+inline EventAwaiter await_release(uint8_t button, uint32_t timeout = 0)
+{
+	return EventAwaiter(button_loop(), button, BUTTON_RELEASED, timeout, timeout != 0);
+}
+
+// wake after ms - always has a deadline, so sleep_ms(0) carries straight on rather than sleeping for ever
+inline EventAwaiter sleep_ms(uint32_t ms)
+{
+	return EventAwaiter(button_loop(), NO_BUTTON, 0, ms, true);
+}
+
+} // namespace debounce
+
+#endif //BUTTON_CORO_HPP
@@ -0,0 +1,288 @@
+/*********************************************************************
+ * capture.c - runs the n button v3 debounce over a logic analyser capture
+ *
+ * Created: 19/10/2026
+ * Author : agent
+ *
+ * See capture.h.  POSIX only (mmap).
+ *
+ **********************************************************************/
+
+#define _DEFAULT_SOURCE
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "capture.h"
+
+#define RELEASE_CHUNK (64UL << 20)  // give read pages back to the kernel every 64MB
+
+typedef struct
+{
+	const uint8_t *data;
+	size_t size;
+	size_t released;  // bytes before this have been handed back
+	size_t pageSize;
+} Mapping;
+
+
+// drop the pages before pos from memory - they are only read once
+static void mapping_release(Mapping *map, size_t pos)
+{
+	size_t end = pos & ~(map->pageSize - 1);
+	if (end - map->released >= RELEASE_CHUNK)
+	{
+		madvise((void *)(map->data + map->released), end - map->released, MADV_DONTNEED);
+		map->released = end;
+	}
+}
+
+
+// one timer tick - levels holds one bit per channel, 1 = high
+static void capture_tick(Capture *cap, uint64_t timeNs, uint64_t levels)
+{
+	for (unsigned c = 0; c < cap->channels; c++)
+	{
+		uint8_t pressed = ((levels >> c) & 1) ^ (cap->activeHigh ? 0 : 1);
+		uint8_t type = host_debounce_sample(&cap->buttons[c], pressed);
+		if (type)
+		{
+			cap->edges++;
+			if (cap->edge) cap->edge(cap, timeNs, c, type);
+		}
+	}
+	if (cap->tick) cap->tick(cap, timeNs);
+	cap->ticks++;
+}
+
+
+static uint64_t tick_ns(const Capture *cap)
+{
+	return (uint64_t)cap->samplePeriodMs * 1000000;
+}
+
+
+static int capture_packed(Capture *cap, Mapping *map)
+{
+	uint64_t samples, tick;
+
+	if (!cap->sampleRate || !cap->unitSize || cap->unitSize > 8)
+	{
+		fprintf(stderr, "packed captures need a sample rate and 1 to 8 bytes per sample\n");
+		return -1;
+	}
+	if (!cap->channels) cap->channels = cap->unitSize * 8;
+	if (cap->channels > cap->unitSize * 8) cap->channels = cap->unitSize * 8;
+	for (unsigned c = 0; c < cap->channels; c++) snprintf(cap->names[c], CAPTURE_NAME_SIZE, "D%u", c);
+
+	// only the sample in force at each tick is needed, so jump straight to it
+	samples = map->size / cap->unitSize;
+	for (tick = 0; ; tick++)
+	{
+		uint64_t index = tick * cap->samplePeriodMs * cap->sampleRate / 1000;
+		uint64_t levels = 0;
+		if (index >= samples) break;
+		for (unsigned b = 0; b < cap->unitSize; b++)
+		{
+			levels |= (uint64_t)map->data[index * cap->unitSize + b] << (8 * b);
+		}
+		capture_tick(cap, tick * tick_ns(cap), levels);
+		mapping_release(map, index * cap->unitSize);
+	}
+	return 0;
+}
+
+
+// the next white space separated word, or 0 at the end of the file
+static size_t vcd_word(const Mapping *map, size_t *pos, const char **word)
+{
+	size_t p = *pos, start;
+	while ((p < map->size) && (map->data[p] <= ' ')) p++;
+	start = p;
+	while ((p < map->size) && (map->data[p] > ' ')) p++;
+	*pos = p;
+	*word = (const char *)map->data + start;
+	return p - start;
+}
+
+
+static int vcd_is(const char *word, size_t len, const char *keyword)
+{
+	return (len == strlen(keyword)) && !memcmp(word, keyword, len);
+}
+
+
+static void vcd_skip_section(const Mapping *map, size_t *pos)
+{
+	const char *word;
+	size_t len;
+	while ((len = vcd_word(map, pos, &word)) && !vcd_is(word, len, "$end"));
+}
+
+
+// the number of ns in one timescale unit, as mult / div
+static void vcd_timescale(const Mapping *map, size_t *pos, uint64_t *mult, uint64_t *div)
+{
+	static const struct { const char *unit; uint64_t fs; } units[] =
+		{{"s", 1000000000000000ULL}, {"ms", 1000000000000ULL}, {"us", 1000000000ULL}, {"ns", 1000000ULL}, {"ps", 1000ULL}, {"fs", 1ULL}};
+	char text[32] = "";
+	const char *word;
+	size_t len;
+	uint64_t number, fs = 1000000;
+	char *unit;
+
+	while ((len = vcd_word(map, pos, &word)) && !vcd_is(word, len, "$end"))
+	{
+		if (strlen(text) + len < sizeof(text)) strncat(text, word, len);  // "1 ns" and "1ns" both end up "1ns"
+	}
+	number = strtoull(text, &unit, 10);
+	for (unsigned u = 0; u < sizeof(units) / sizeof(units[0]); u++)
+	{
+		if (!strcmp(unit, units[u].unit)) fs = (number ? number : 1) * units[u].fs;
+	}
+	if (fs >= 1000000)
+	{
+		*mult = fs / 1000000;
+		*div = 1;
+	} else
+	{
+		*mult = 1;
+		*div = 1000000 / fs;
+	}
+}
+
+
+static int capture_vcd(Capture *cap, Mapping *map)
+{
+	int16_t shortIds[256];      // channel for each 1 character id - what sigrok writes
+	char longIds[CAPTURE_MAX_CHANNELS][8];
+	uint64_t mult = 1, div = 1, levels = 0, nextTick = 0, now = 0;
+	const char *word;
+	size_t len, pos = 0;
+
+	memset(shortIds, 0xFF, sizeof(shortIds));
+	cap->channels = 0;
+
+	// the header, up to $enddefinitions
+	while ((len = vcd_word(map, &pos, &word)))
+	{
+		if (vcd_is(word, len, "$enddefinitions"))
+		{
+			vcd_skip_section(map, &pos);
+			break;
+		} else if (vcd_is(word, len, "$timescale"))
+		{
+			vcd_timescale(map, &pos, &mult, &div);
+		} else if (vcd_is(word, len, "$var"))
+		{
+			const char *type, *size, *id, *name;
+			size_t typeLen = vcd_word(map, &pos, &type);
+			size_t sizeLen = vcd_word(map, &pos, &size);
+			size_t idLen = vcd_word(map, &pos, &id);
+			size_t nameLen = vcd_word(map, &pos, &name);
+			(void)typeLen;
+			if ((sizeLen == 1) && (*size == '1') && (idLen < sizeof(longIds[0])) && (cap->channels < CAPTURE_MAX_CHANNELS))
+			{
+				unsigned c = cap->channels++;
+				if (idLen == 1) shortIds[(uint8_t)*id] = c;
+				memcpy(longIds[c], id, idLen);
+				longIds[c][idLen] = 0;
+				if (nameLen >= CAPTURE_NAME_SIZE) nameLen = CAPTURE_NAME_SIZE - 1;
+				memcpy(cap->names[c], name, nameLen);
+				cap->names[c][nameLen] = 0;
+			}
+			vcd_skip_section(map, &pos);
+		} else if (word[0] == '$')
+		{
+			vcd_skip_section(map, &pos);  // $date, $version, $scope, $comment ...
+		}
+	}
+	if (!cap->channels)
+	{
+		fprintf(stderr, "no 1 bit wires in the VCD header\n");
+		return -1;
+	}
+	if (!cap->activeHigh) levels = ~0ULL;  // before the first value the buttons are up
+
+	// the value changes
+	while ((len = vcd_word(map, &pos, &word)))
+	{
+		if (word[0] == '#')
+		{
+			now = strtoull(word + 1, NULL, 10) * mult / div;
+			while (nextTick < now)  // the ticks before this time see the levels so far
+			{
+				capture_tick(cap, nextTick, levels);
+				nextTick += tick_ns(cap);
+			}
+			mapping_release(map, pos);
+		} else if ((word[0] == '0') || (word[0] == '1') || (word[0] == 'x') || (word[0] == 'X') || (word[0] == 'z') || (word[0] == 'Z'))
+		{
+			int c = -1;
+			if (len == 2) c = shortIds[(uint8_t)word[1]];
+			else for (unsigned i = 0; i < cap->channels; i++)
+			{
+				if ((strlen(longIds[i]) == len - 1) && !memcmp(longIds[i], word + 1, len - 1)) c = i;
+			}
+			if (c >= 0 && word[0] == '0') levels &= ~(1ULL << c);
+			if (c >= 0 && word[0] == '1') levels |= 1ULL << c;  // x and z keep the last level
+		} else if ((word[0] == 'b') || (word[0] == 'B') || (word[0] == 'r') || (word[0] == 'R'))
+		{
+			vcd_word(map, &pos, &word);  // a vector or real and its id - not a button
+		}
+		// $dumpvars, $end etc need nothing
+	}
+	while (nextTick <= now)
+	{
+		capture_tick(cap, nextTick, levels);
+		nextTick += tick_ns(cap);
+	}
+	return 0;
+}
+
+
+int debounce_capture(Capture *cap, const char *path)
+{
+	Mapping map;
+	struct stat st;
+	int fd, result;
+
+	if (!cap->samplePeriodMs)
+	{
+		fprintf(stderr, "the sample period must be at least 1ms\n");
+		return -1;
+	}
+	if ((fd = open(path, O_RDONLY)) < 0)
+	{
+		perror(path);
+		return -1;
+	}
+	if (fstat(fd, &st) < 0 || st.st_size == 0)
+	{
+		fprintf(stderr, "%s: empty or unreadable\n", path);
+		close(fd);
+		return -1;
+	}
+	map.size = st.st_size;
+	map.released = 0;
+	map.pageSize = sysconf(_SC_PAGESIZE);
+	map.data = mmap(NULL, map.size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (map.data == MAP_FAILED)
+	{
+		perror(path);
+		return -1;
+	}
+	madvise((void *)map.data, map.size, MADV_SEQUENTIAL);
+
+	memset(cap->buttons, 0, sizeof(cap->buttons));
+	cap->ticks = cap->edges = 0;
+	result = (cap->format == CAPTURE_VCD) ? capture_vcd(cap, &map) : capture_packed(cap, &map);
+
+	munmap((void *)map.data, map.size);
+	return result;
+}
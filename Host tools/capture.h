@@ -0,0 +1,59 @@
+/*********************************************************************
+ * capture.h - runs the n button v3 debounce over a logic analyser capture
+ *
+ * Created: 19/10/2026
+ * Author : agent
+ *
+ * debounce_capture() maps the capture file into memory and makes one pass over it, sampling every channel
+ * every samplePeriodMs like the timer ISR does (the level at each tick is the last one seen at or before it)
+ * and calling edge() for each debounced press and release, and tick() after every tick if it is set.  The pages already read are handed back to the
+ * kernel as it goes, so a capture of many GB runs in the same small amount of memory.
+ *
+ * Formats:
+ *   CAPTURE_PACKED  unitSize bytes per sample at sampleRate, channel 0 in bit 0 of the first byte - what
+ *                   "sigrok-cli -O binary" writes
+ *   CAPTURE_VCD     value change dump of 1 bit wires, eg "sigrok-cli -O vcd".  Vectors and reals are skipped
+ *
+ * capture_debounce.c is the command line tool built on it.
+ *
+ **********************************************************************/
+
+#ifndef CAPTURE_H
+#define CAPTURE_H
+
+#include <stdint.h>
+#include "host_debounce.h"
+
+#define CAPTURE_MAX_CHANNELS 64
+#define CAPTURE_NAME_SIZE 32
+
+typedef enum
+{
+	CAPTURE_PACKED,
+	CAPTURE_VCD
+} CaptureFormat;
+
+typedef struct Capture
+{
+	// set these before calling debounce_capture()
+	CaptureFormat format;
+	uint64_t sampleRate;        // Hz, packed only
+	unsigned unitSize;          // bytes per sample, packed only
+	unsigned channels;          // packed only, 0 for unitSize * 8 (VCD fills it in)
+	unsigned samplePeriodMs;    // the bank's sample period - defaultConfig in n_button_debounce_v3.c samples every 1ms
+	int activeHigh;             // 0 - a low level is pressed, like the buttons with their pull ups
+	void (*edge)(struct Capture *cap, uint64_t timeNs, unsigned channel, uint8_t type);
+	void (*tick)(struct Capture *cap, uint64_t timeNs);  // after each tick, or NULL - buttons[] hold the state
+	void *user;
+
+	// filled in by debounce_capture()
+	char names[CAPTURE_MAX_CHANNELS][CAPTURE_NAME_SIZE];
+	uint64_t ticks;
+	uint64_t edges;
+	HostButton buttons[CAPTURE_MAX_CHANNELS];
+} Capture;
+
+// returns 0, or -1 with a message on stderr
+int debounce_capture(Capture *cap, const char *path);
+
+#endif //CAPTURE_H
@@ -0,0 +1,116 @@
+/*********************************************************************
+ * capture_debounce.c - debounces a logic analyser capture of the buttons
+ *
+ * Created: 19/10/2026
+ * Author : agent
+ *
+ * Usage: capture_debounce [options] capture
+ *   -f packed|vcd   the capture format (default vcd for a .vcd file, otherwise packed)
+ *   -r rate         sample rate in Hz (packed)
+ *   -u bytes        bytes per sample, 1 to 8 (packed, default 1)
+ *   -c channels     channels to debounce (packed, default all the bits)
+ *   -p ms           the bank's sample period (default 1, as defaultConfig in n_button_debounce_v3.c)
+ *   -H              the buttons are active high (default active low)
+ *   -o file         write the edges here (default stdout)
+ *   -t file.vcd     also write a trace of the raw samples, history bytes and debounced states for GTKWave
+ *
+ * eg  sigrok-cli -d fx2lafw --config samplerate=1m --time 10s -O binary > buttons.bin
+ *     capture_debounce -r 1000000 buttons.bin
+ *
+ * Prints one line per debounced edge:  <ms> <channel> pressed|released  and a summary on stderr.
+ *
+ * Build: gcc -O2 -I"../Library files/n_button_V3" -o capture_debounce capture_debounce.c capture.c vcd_trace.c
+ *
+ **********************************************************************/
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "capture.h"
+#include "vcd_trace.h"
+
+static VcdTrace trace;
+static const char *tracePath;
+static int traceFailed;
+
+static void print_edge(Capture *cap, uint64_t timeNs, unsigned channel, uint8_t type)
+{
+	fprintf(cap->user, "%llu.%03llu %s %s\n", (unsigned long long)(timeNs / 1000000), (unsigned long long)(timeNs / 1000 % 1000),
+		cap->names[channel], (type == BUTTON_PRESSED) ? "pressed" : "released");
+}
+
+static void trace_tick(Capture *cap, uint64_t timeNs)
+{
+	if (!trace.file)  // opened on the first tick, once the channel names are known
+	{
+		if (vcd_trace_open(&trace, tracePath, cap->names, cap->channels))
+		{
+			traceFailed = 1;
+			cap->tick = NULL;
+			return;
+		}
+	}
+	vcd_trace_time(&trace, timeNs);
+	for (unsigned c = 0; c < cap->channels; c++) vcd_trace_button(&trace, c, cap->buttons[c].history, cap->buttons[c].down);
+}
+
+int main(int argc, char *argv[])
+{
+	Capture cap;
+	const char *format = NULL;
+	FILE *out = stdout;
+	size_t len;
+	int opt;
+
+	memset(&cap, 0, sizeof(cap));
+	cap.unitSize = 1;
+	cap.samplePeriodMs = 1;  // defaultConfig's period
+	while ((opt = getopt(argc, argv, "f:r:u:c:p:Ho:t:")) != -1)
+	{
+		switch (opt)
+		{
+			case 'f': format = optarg; break;
+			case 'r': cap.sampleRate = strtoull(optarg, NULL, 10); break;
+			case 'u': cap.unitSize = atoi(optarg); break;
+			case 'c': cap.channels = atoi(optarg); break;
+			case 'p': cap.samplePeriodMs = atoi(optarg); break;
+			case 'H': cap.activeHigh = 1; break;
+			case 't': tracePath = optarg; break;
+			case 'o':
+				if (!(out = fopen(optarg, "w")))
+				{
+					perror(optarg);
+					return 1;
+				}
+				break;
+			default:
+				fprintf(stderr, "usage: %s [-f packed|vcd] [-r rate] [-u bytes] [-c channels] [-p ms] [-H] [-o file] [-t file.vcd] capture\n", argv[0]);
+				return 1;
+		}
+	}
+	if (optind != argc - 1)
+	{
+		fprintf(stderr, "usage: %s [-f packed|vcd] [-r rate] [-u bytes] [-c channels] [-p ms] [-H] [-o file] [-t file.vcd] capture\n", argv[0]);
+		return 1;
+	}
+	len = strlen(argv[optind]);
+	if (format) cap.format = strcmp(format, "vcd") ? CAPTURE_PACKED : CAPTURE_VCD;
+	else cap.format = ((len > 4) && !strcmp(argv[optind] + len - 4, ".vcd")) ? CAPTURE_VCD : CAPTURE_PACKED;
+	cap.edge = print_edge;
+	cap.user = out;
+
+	if (tracePath) cap.tick = trace_tick;
+
+	if (debounce_capture(&cap, argv[optind]) || traceFailed) return 1;
+	if (tracePath && vcd_trace_close(&trace))
+	{
+		perror(tracePath);
+		return 1;
+	}
+	fprintf(stderr, "%u channels, %llu ticks of %ums, %llu edges\n", cap.channels, (unsigned long long)cap.ticks,
+		cap.samplePeriodMs, (unsigned long long)cap.edges);
+	if (out != stdout) fclose(out);
+	return 0;
+}
@@ -0,0 +1,392 @@
+/*********************************************************************
+ * debounce_sweep.c - Monte Carlo sweep of sample period, window and debounce algorithm
+ *
+ * Created: 19/10/2026
+ * Author : agent
+ *
+ * Usage: debounce_sweep [options]
+ *   -n trials     presses simulated for each setting (default 10000)
+ *   -r seed       random seed - the same seed gives the same CSV (default 1)
+ *   -b count      average bounces on each press and release (default 4)
+ *   -B us         average length of each bounce (default 300)
+ *   -d rate       average dropouts per second while held (default 0.5)
+ *   -D us         average length of a dropout (default 200)
+ *   -t threads    threads to run the settings on (default the number of cores)
+ *   -a            print every setting, not just the Pareto frontier
+ *
+ * Choosing a bank's sample period (samplePeriod in its DebounceBankConfig - defaultConfig's is 1ms), the
+ * history length and the press/release patterns is guesswork, so this tries them all against a statistical
+ * switch.  Each trial is a press and release: the number of bounces on each edge is Poisson distributed, each
+ * bounce and dropout length is exponential, dropouts (the contact opening for a moment while held, eg from
+ * vibration) arrive at random while the button is held, and the hold and idle times are uniform.  Every setting sees exactly the same switch, sampled from a random phase.
+ *
+ * Settings tried - sample period 1, 2, 5, 10 and 20ms, times window 2 to 8 samples, times algorithm:
+ *   pattern     the v3 library rules - press when the history is window 1's with 0's above them
+ *               (PRESSED_PATTERN 0b00111111 is window 6), release when it is window 0's with 1's above
+ *   edge        only the window samples and the one before are looked at (masked patterns, like v1)
+ *   integrator  a counter going up on a pressed sample and down on a released one, changing state at
+ *               window and 0
+ * All of them also decide on a history of all 1's or all 0's, like the library.
+ *
+ * For each setting it works out the latency from the real edge to the decision and the false events per
+ * 1000 presses - extra presses or releases from bounces and dropouts plus presses or releases missed
+ * altogether.  Prints CSV:
+ *   algorithm,period_ms,window,mean_latency_ms,p99_latency_ms,false_per_1000,missed_per_1000,pareto
+ * where pareto is 1 if no other setting is both as quick and as clean (by mean latency and false + missed
+ * events).  Without -a only those rows are printed, quickest first.
+ *
+ * Build: gcc -O2 -pthread -I"../Library files/n_button_V3" -o debounce_sweep debounce_sweep.c -lm
+ *
+ **********************************************************************/
+
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include "host_debounce.h"
+
+#define MAX_TRANSITIONS 512  // per trial - bounces and dropouts past this are left out
+
+enum { ALG_PATTERN, ALG_EDGE, ALG_INTEGRATOR, ALG_COUNT };
+static const char *algNames[ALG_COUNT] = {"pattern", "edge", "integrator"};
+static const unsigned periods[] = {1, 2, 5, 10, 20};
+#define PERIOD_COUNT (sizeof(periods) / sizeof(periods[0]))
+#define WINDOW_MIN 2
+#define WINDOW_MAX 8
+
+typedef struct
+{
+	unsigned trials;
+	uint64_t seed;
+	double bounces;        // mean count per edge
+	double bounceUs;       // mean length
+	double dropoutRate;    // per second held
+	double dropoutUs;      // mean length
+} SwitchModel;
+
+typedef struct
+{
+	unsigned algorithm;
+	unsigned periodMs;
+	unsigned window;
+	uint8_t table[256];    // history classification, pattern and edge
+	double meanLatency;
+	double p99Latency;
+	double falsePer1000;
+	double missedPer1000;
+	int pareto;
+} Setting;
+
+typedef struct
+{
+	uint8_t history;
+	uint8_t down;
+	uint8_t count;         // the integrator
+} AlgState;
+
+typedef struct
+{
+	double time;           // us
+	uint8_t level;         // 1 = pressed from this time
+} Transition;
+
+typedef struct
+{
+	const SwitchModel *model;
+	Setting *settings;
+	unsigned count;
+	atomic_uint next;
+} Sweep;
+
+
+static uint64_t splitmix(uint64_t *state)
+{
+	uint64_t z = (*state += 0x9E3779B97F4A7C15ULL);
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+	return z ^ (z >> 31);
+}
+
+static double uniform(uint64_t *rng)
+{
+	return (splitmix(rng) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+static double exponential(uint64_t *rng, double mean)
+{
+	return -mean * log(1.0 - uniform(rng));
+}
+
+static unsigned poisson(uint64_t *rng, double mean)
+{
+	double limit = exp(-mean), p = uniform(rng);
+	unsigned k = 0;
+	while (p > limit)
+	{
+		k++;
+		p *= uniform(rng);
+	}
+	return k;
+}
+
+
+static void setting_build(Setting *s)
+{
+	unsigned w = s->window;
+	for (unsigned h = 0; h < 256; h++)
+	{
+		if (s->algorithm == ALG_PATTERN)
+		{
+			s->table[h] = HISTORY_CLASSIFY(h, 0xFF, (1u << w) - 1, 0xFF, (0xFFu << w) & 0xFF);
+		} else
+		{
+			uint8_t mask = (w >= 8) ? 0xFF : (1u << (w + 1)) - 1;
+			s->table[h] = HISTORY_CLASSIFY(h, mask, (1u << w) - 1, mask, (1u << w) & 0xFF);
+		}
+	}
+}
+
+
+// one sample through the setting's algorithm - returns BUTTON_PRESSED, BUTTON_RELEASED or 0
+static uint8_t setting_sample(const Setting *s, AlgState *state, uint8_t sample)
+{
+	if (s->algorithm == ALG_INTEGRATOR)
+	{
+		if (sample && state->count < s->window) state->count++;
+		if (!sample && state->count) state->count--;
+		if (!state->down && state->count == s->window)
+		{
+			state->down = 1;
+			return BUTTON_PRESSED;
+		}
+		if (state->down && !state->count)
+		{
+			state->down = 0;
+			return BUTTON_RELEASED;
+		}
+		return 0;
+	}
+
+	// the library's decision, from the table (host_debounce_sample() with this setting's table)
+	uint8_t cls;
+	state->history = debounce_shift(state->history, sample);
+	cls = s->table[state->history];
+	if (!state->down)
+	{
+		if (cls & (HISTORY_PRESSED | HISTORY_DOWN))
+		{
+			state->down = 1;
+			return BUTTON_PRESSED;
+		}
+	} else if (cls & (HISTORY_RELEASED | HISTORY_UP))
+	{
+		state->down = 0;
+		return BUTTON_RELEASED;
+	}
+	return 0;
+}
+
+
+// a bouncing edge at start to level - returns the number of transitions written
+static unsigned bounce_edge(uint64_t *rng, const SwitchModel *model, Transition *t, unsigned room, double start, uint8_t level, double *end)
+{
+	unsigned n = 0, bounces = poisson(rng, model->bounces);
+	double time = start;
+
+	if (room) t[n++] = (Transition){time, level};
+	for (unsigned b = 0; b < bounces && n + 2 <= room; b++)
+	{
+		time += exponential(rng, model->bounceUs);
+		t[n++] = (Transition){time, !level};
+		time += exponential(rng, model->bounceUs);
+		t[n++] = (Transition){time, level};
+	}
+	*end = time;
+	return n;
+}
+
+
+static int compare_double(const void *a, const void *b)
+{
+	double x = *(const double *)a, y = *(const double *)b;
+	return (x > y) - (x < y);
+}
+
+
+static void setting_run(Setting *s, const SwitchModel *model)
+{
+	uint64_t rng = model->seed;                     // the switch - the same for every setting
+	uint64_t phaseRng = model->seed ^ 0x5A5A5A5AULL;
+	Transition t[MAX_TRANSITIONS];
+	double *latencies = malloc(sizeof(double) * model->trials * 2);
+	double period = s->periodMs * 1000.0;
+	double sampleTime = uniform(&phaseRng) * period;
+	double tp = 100000 + uniform(&rng) * 900000;     // first press
+	unsigned latencyCount = 0, falseEvents = 0, missed = 0;
+	AlgState state = {0, 0, 0};
+	double latencySum = 0;
+
+	for (unsigned trial = 0; trial < model->trials; trial++)
+	{
+		double hold = 80000 + uniform(&rng) * 920000;
+		double tr = tp + hold, settled, end, nextTp;
+		unsigned n = 0, next = 0;
+		int pressSeen = 0, releaseSeen = 0;
+		uint8_t level = 0;
+
+		n += bounce_edge(&rng, model, t + n, MAX_TRANSITIONS - n, tp, 1, &settled);
+		for (double d = settled + exponential(&rng, 1e6 / model->dropoutRate); d < tr && n + 2 <= MAX_TRANSITIONS; d += exponential(&rng, 1e6 / model->dropoutRate))
+		{
+			double length = exponential(&rng, model->dropoutUs);
+			if (d + length >= tr) break;
+			t[n++] = (Transition){d, 0};
+			t[n++] = (Transition){d + length, 1};
+			d += length;
+		}
+		if (t[n - 1].time >= tr) tr = t[n - 1].time + 1;  // a long bounce runs into the release
+		n += bounce_edge(&rng, model, t + n, MAX_TRANSITIONS - n, tr, 0, &end);
+		nextTp = end + 100000 + uniform(&rng) * 900000;
+
+		// sample from here to the next press
+		for (; sampleTime < nextTp; sampleTime += period)
+		{
+			while (next < n && t[next].time <= sampleTime) level = t[next++].level;
+			uint8_t event = setting_sample(s, &state, level);
+			if (!event) continue;
+			if (sampleTime < tp || (event == BUTTON_PRESSED && (pressSeen || sampleTime >= tr)) ||
+				(event == BUTTON_RELEASED && (releaseSeen || sampleTime < tr)))
+			{
+				falseEvents++;
+			} else if (event == BUTTON_PRESSED)
+			{
+				pressSeen = 1;
+				latencies[latencyCount++] = (sampleTime - tp) / 1000;
+			} else
+			{
+				releaseSeen = 1;
+				latencies[latencyCount++] = (sampleTime - tr) / 1000;
+			}
+		}
+		missed += !pressSeen + !releaseSeen;
+		tp = nextTp;
+	}
+
+	for (unsigned i = 0; i < latencyCount; i++) latencySum += latencies[i];
+	qsort(latencies, latencyCount, sizeof(double), compare_double);
+	s->meanLatency = latencyCount ? latencySum / latencyCount : INFINITY;
+	s->p99Latency = latencyCount ? latencies[(latencyCount - 1) * 99 / 100] : INFINITY;
+	s->falsePer1000 = 1000.0 * falseEvents / model->trials;
+	s->missedPer1000 = 1000.0 * missed / model->trials;
+	free(latencies);
+}
+
+
+static void *sweep_worker(void *arg)
+{
+	Sweep *sweep = arg;
+	unsigned i;
+	while ((i = atomic_fetch_add(&sweep->next, 1)) < sweep->count)
+	{
+		setting_run(&sweep->settings[i], sweep->model);
+	}
+	return NULL;
+}
+
+
+static int compare_latency(const void *a, const void *b)
+{
+	const Setting *x = a, *y = b;
+	return (x->meanLatency > y->meanLatency) - (x->meanLatency < y->meanLatency);
+}
+
+
+int main(int argc, char *argv[])
+{
+	SwitchModel model = {10000, 1, 4, 300, 0.5, 200};
+	unsigned threads = sysconf(_SC_NPROCESSORS_ONLN);
+	Setting settings[ALG_COUNT * PERIOD_COUNT * (WINDOW_MAX - WINDOW_MIN + 1)];
+	Sweep sweep;
+	pthread_t *ids;
+	int all = 0, opt;
+
+	while ((opt = getopt(argc, argv, "n:r:b:B:d:D:t:a")) != -1)
+	{
+		switch (opt)
+		{
+			case 'n': model.trials = atoi(optarg); break;
+			case 'r': model.seed = strtoull(optarg, NULL, 10); break;
+			case 'b': model.bounces = atof(optarg); break;
+			case 'B': model.bounceUs = atof(optarg); break;
+			case 'd': model.dropoutRate = atof(optarg); break;
+			case 'D': model.dropoutUs = atof(optarg); break;
+			case 't': threads = atoi(optarg); break;
+			case 'a': all = 1; break;
+			default:
+				fprintf(stderr, "usage: %s [-n trials] [-r seed] [-b count] [-B us] [-d rate] [-D us] [-t threads] [-a]\n", argv[0]);
+				return 1;
+		}
+	}
+	if (!model.trials || !threads || model.dropoutRate <= 0 || model.bounceUs <= 0)
+	{
+		fprintf(stderr, "trials, threads, dropout rate and bounce length must be more than 0\n");
+		return 1;
+	}
+
+	sweep.model = &model;
+	sweep.settings = settings;
+	sweep.count = 0;
+	atomic_init(&sweep.next, 0);
+	for (unsigned a = 0; a < ALG_COUNT; a++)
+	{
+		for (unsigned p = 0; p < PERIOD_COUNT; p++)
+		{
+			for (unsigned w = WINDOW_MIN; w <= WINDOW_MAX; w++)
+			{
+				Setting *s = &settings[sweep.count++];
+				memset(s, 0, sizeof(*s));
+				s->algorithm = a;
+				s->periodMs = periods[p];
+				s->window = w;
+				setting_build(s);
+			}
+		}
+	}
+
+	ids = calloc(threads, sizeof(pthread_t));
+	for (unsigned i = 1; i < threads; i++) pthread_create(&ids[i], NULL, sweep_worker, &sweep);
+	sweep_worker(&sweep);
+	for (unsigned i = 1; i < threads; i++) pthread_join(ids[i], NULL);
+	free(ids);
+
+	// the frontier - a setting is on it unless another is no slower and no less clean, and better at one
+	for (unsigned i = 0; i < sweep.count; i++)
+	{
+		double bad = settings[i].falsePer1000 + settings[i].missedPer1000;
+		settings[i].pareto = 1;
+		for (unsigned j = 0; j < sweep.count && settings[i].pareto; j++)
+		{
+			double otherBad = settings[j].falsePer1000 + settings[j].missedPer1000;
+			if (settings[j].meanLatency <= settings[i].meanLatency && otherBad <= bad &&
+				(settings[j].meanLatency < settings[i].meanLatency || otherBad < bad))
+			{
+				settings[i].pareto = 0;
+			}
+		}
+	}
+	if (!all) qsort(settings, sweep.count, sizeof(Setting), compare_latency);
+
+	printf("algorithm,period_ms,window,mean_latency_ms,p99_latency_ms,false_per_1000,missed_per_1000,pareto\n");
+	for (unsigned i = 0; i < sweep.count; i++)
+	{
+		Setting *s = &settings[i];
+		if (!all && !s->pareto) continue;
+		printf("%s,%u,%u,%.2f,%.2f,%.2f,%.2f,%d\n", algNames[s->algorithm], s->periodMs, s->window, s->meanLatency,
+			s->p99Latency, s->falsePer1000, s->missedPer1000, s->pareto);
+	}
+	return 0;
+}
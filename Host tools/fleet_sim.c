@@ -0,0 +1,350 @@
+/*********************************************************************
+ * fleet_sim.c - runs the debounce over a whole installation of simulated switches on every core
+ *
+ * Created: 19/10/2026
+ * Author : agent
+ *
+ * Usage: fleet_sim [-c channels] [-s seconds] [-p ms] [-t threads] [-S shard] [-r seed]
+ *   -c channels   switches to simulate (default 200000)
+ *   -s seconds    simulated time (default 60)
+ *   -p ms         the bank's sample period (default 1, as defaultConfig in n_button_debounce_v3.c)
+ *   -t threads    the most threads to try (default the number of cores)
+ *   -S shard      switches per shard (default 4096)
+ *   -r seed       seed for the switch models (default 1)
+ *
+ * Every switch has its own bounce model, drawn from the seed: how long it is held, how many times it
+ * bounces on each press and release and how long each bounce lasts.  The switches are split into shards and
+ * the shards are shared out between the threads.  Each thread works through its own list and, when that is
+ * done, steals shards from the others, so a slow core doesn't hold everyone up.  Each shard's state is
+ * allocated on its own cache lines so two threads never write to the same line.
+ *
+ * The debounce is host_debounce.h - the same shift, table and decisions as update_button() and the ISR.
+ * A single threaded reference using the is_button_...() rules (history_is_...() from
+ * n_button_debounce_v3_inline.h) runs first, and every threaded run must give the same presses, releases
+ * and final history of every switch, or it is reported as a MISMATCH.
+ *
+ * Prints the time, switch updates per second, speed up and scaling efficiency for 1, 2, 4 ... threads.
+ *
+ * Build: gcc -O2 -pthread -I"../Library files/n_button_V3" -o fleet_sim fleet_sim.c
+ *
+ **********************************************************************/
+
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include "host_debounce.h"
+
+#define CACHE_LINE 64
+
+typedef struct
+{
+	uint64_t rng;
+	uint32_t nextChange;   // ms when the switch next changes
+	uint8_t target;        // where the switch settles, 1 = pressed
+	uint8_t level;         // what the pin reads now
+	uint8_t bouncesLeft;   // flips still to come before it settles
+	uint8_t maxBounces;    // this switch's model
+	uint8_t bounceMs;
+	uint16_t holdMs;
+} SwitchModel;
+
+typedef struct
+{
+	HostButton *buttons;
+	SwitchModel *models;
+	uint32_t *presses;
+	uint32_t first;
+	uint32_t count;
+	uint64_t checksum;
+} __attribute__((aligned(CACHE_LINE))) Shard;
+
+typedef struct
+{
+	atomic_uint next;      // the next shard to take from this list
+	unsigned end;
+} __attribute__((aligned(CACHE_LINE))) WorkList;
+
+typedef struct
+{
+	Shard *shards;
+	WorkList *lists;
+	unsigned threads;
+	unsigned index;
+	uint32_t ticks;
+	unsigned periodMs;
+	pthread_t thread;
+} Worker;
+
+static uint64_t splitmix(uint64_t *state)
+{
+	uint64_t z = (*state += 0x9E3779B97F4A7C15ULL);
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+	return z ^ (z >> 31);
+}
+
+static uint32_t random_below(uint64_t *state, uint32_t limit)
+{
+	return (uint32_t)(splitmix(state) % limit);
+}
+
+
+static void model_start(SwitchModel *model, uint64_t seed, uint32_t channel)
+{
+	memset(model, 0, sizeof(*model));
+	model->rng = seed ^ ((uint64_t)channel * 0xD1B54A32D192ED03ULL);
+	model->maxBounces = random_below(&model->rng, 12);      // 0 to 11 bounces on each edge
+	model->bounceMs = 1 + random_below(&model->rng, 4);     // 1 to 4ms between flips
+	model->holdMs = 50 + random_below(&model->rng, 2000);   // held or left for up to ~2s
+	model->nextChange = random_below(&model->rng, model->holdMs);
+}
+
+
+// the pin level of the switch at time now (ms)
+static uint8_t model_level(SwitchModel *model, uint32_t now)
+{
+	while (now >= model->nextChange)
+	{
+		if (model->bouncesLeft)
+		{
+			model->level ^= 1;
+			model->bouncesLeft--;
+			model->nextChange += 1 + random_below(&model->rng, model->bounceMs);
+		} else if (model->level != model->target)
+		{
+			model->level = model->target;  // bouncing finished
+			model->nextChange += model->holdMs / 2 + random_below(&model->rng, model->holdMs);
+		} else
+		{
+			model->target ^= 1;  // the next press or release, starting with a bounce
+			model->level = model->target;
+			model->bouncesLeft = 2 * random_below(&model->rng, model->maxBounces + 1);
+			model->nextChange += 1 + random_below(&model->rng, model->bounceMs);
+		}
+	}
+	return model->level;
+}
+
+
+static void shard_reset(Shard *shard, uint64_t seed)
+{
+	for (uint32_t i = 0; i < shard->count; i++)
+	{
+		model_start(&shard->models[i], seed, shard->first + i);
+		shard->buttons[i] = (HostButton){0, 0};
+		shard->presses[i] = 0;
+	}
+	shard->checksum = 0;
+}
+
+
+static uint64_t channel_hash(uint32_t channel, const HostButton *button, uint32_t presses)
+{
+	uint64_t h = ((uint64_t)channel << 32) ^ ((uint64_t)presses << 9) ^ ((uint64_t)button->history << 1) ^ button->down;
+	return splitmix(&h);
+}
+
+
+// the engine - shard at a time, all the ticks for one switch before the next, so a switch stays in the cache
+static void shard_run(Shard *shard, uint32_t ticks, unsigned periodMs)
+{
+	uint64_t checksum = 0;
+	for (uint32_t i = 0; i < shard->count; i++)
+	{
+		HostButton button = shard->buttons[i];
+		SwitchModel model = shard->models[i];
+		uint32_t presses = shard->presses[i];
+		for (uint32_t t = 0; t < ticks; t++)
+		{
+			if (host_debounce_sample(&button, model_level(&model, t * periodMs)) == BUTTON_PRESSED) presses++;
+		}
+		shard->buttons[i] = button;
+		shard->models[i] = model;
+		shard->presses[i] = presses;
+		checksum += channel_hash(shard->first + i, &button, presses);  // order doesn't matter
+	}
+	shard->checksum = checksum;
+}
+
+
+// the same switches through the is_button_...() rules, one switch at a time
+static uint64_t reference_run(Shard *shards, unsigned count, uint32_t ticks, unsigned periodMs)
+{
+	uint64_t checksum = 0;
+	for (unsigned s = 0; s < count; s++)
+	{
+		Shard *shard = &shards[s];
+		for (uint32_t i = 0; i < shard->count; i++)
+		{
+			HostButton button = {0, 0};
+			uint32_t presses = 0;
+			for (uint32_t t = 0; t < ticks; t++)
+			{
+				button.history = debounce_shift(button.history, model_level(&shard->models[i], t * periodMs));
+				if (!button.down && (history_is_pressed(button.history) || history_is_down(button.history)))
+				{
+					button.down = 1;
+					presses++;
+				} else if (button.down && (history_is_released(button.history) || history_is_up(button.history)))
+				{
+					button.down = 0;
+				}
+			}
+			checksum += channel_hash(shard->first + i, &button, presses);
+		}
+	}
+	return checksum;
+}
+
+
+// take a shard from list, or return -1 if it is empty
+static int take_shard(WorkList *list)
+{
+	unsigned s = atomic_fetch_add_explicit(&list->next, 1, memory_order_relaxed);
+	return (s < list->end) ? (int)s : -1;
+}
+
+
+static void *worker_main(void *arg)
+{
+	Worker *worker = arg;
+	int s;
+
+	while ((s = take_shard(&worker->lists[worker->index])) >= 0)
+	{
+		shard_run(&worker->shards[s], worker->ticks, worker->periodMs);
+	}
+	for (unsigned v = 1; v < worker->threads; v++)  // then steal from the others
+	{
+		WorkList *victim = &worker->lists[(worker->index + v) % worker->threads];
+		while ((s = take_shard(victim)) >= 0)
+		{
+			shard_run(&worker->shards[s], worker->ticks, worker->periodMs);
+		}
+	}
+	return NULL;
+}
+
+
+static double seconds_now(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+
+static void *cache_alloc(size_t size)
+{
+	void *p = aligned_alloc(CACHE_LINE, (size + CACHE_LINE - 1) / CACHE_LINE * CACHE_LINE);
+	if (!p)
+	{
+		perror("fleet_sim");
+		exit(1);
+	}
+	return p;
+}
+
+
+// run all the shards on threads threads - returns the seconds taken and sets *checksum
+static double threaded_run(Shard *shards, unsigned shardCount, unsigned threads, uint32_t ticks, unsigned periodMs, uint64_t *checksum)
+{
+	WorkList *lists = cache_alloc(threads * sizeof(WorkList));
+	Worker *workers = calloc(threads, sizeof(Worker));
+	double start;
+
+	for (unsigned w = 0; w < threads; w++)
+	{
+		atomic_init(&lists[w].next, (unsigned)((uint64_t)shardCount * w / threads));
+		lists[w].end = (unsigned)((uint64_t)shardCount * (w + 1) / threads);
+		workers[w] = (Worker){shards, lists, threads, w, ticks, periodMs, 0};
+	}
+	start = seconds_now();
+	for (unsigned w = 1; w < threads; w++) pthread_create(&workers[w].thread, NULL, worker_main, &workers[w]);
+	worker_main(&workers[0]);
+	for (unsigned w = 1; w < threads; w++) pthread_join(workers[w].thread, NULL);
+	start = seconds_now() - start;
+
+	*checksum = 0;
+	for (unsigned s = 0; s < shardCount; s++) *checksum += shards[s].checksum;
+	free(workers);
+	free(lists);
+	return start;
+}
+
+
+int main(int argc, char *argv[])
+{
+	uint32_t channels = 200000, shardSize = 4096;
+	unsigned seconds = 60, periodMs = 1, maxThreads = sysconf(_SC_NPROCESSORS_ONLN);
+	uint64_t seed = 1, reference, checksum;
+	unsigned shardCount;
+	uint32_t ticks;
+	Shard *shards;
+	double base = 0;
+	int opt, failed = 0;
+
+	while ((opt = getopt(argc, argv, "c:s:p:t:S:r:")) != -1)
+	{
+		switch (opt)
+		{
+			case 'c': channels = strtoul(optarg, NULL, 10); break;
+			case 's': seconds = atoi(optarg); break;
+			case 'p': periodMs = atoi(optarg); break;
+			case 't': maxThreads = atoi(optarg); break;
+			case 'S': shardSize = strtoul(optarg, NULL, 10); break;
+			case 'r': seed = strtoull(optarg, NULL, 10); break;
+			default:
+				fprintf(stderr, "usage: %s [-c channels] [-s seconds] [-p ms] [-t threads] [-S shard] [-r seed]\n", argv[0]);
+				return 1;
+		}
+	}
+	if (!channels || !shardSize || !periodMs || !maxThreads)
+	{
+		fprintf(stderr, "channels, shard size, period and threads must all be at least 1\n");
+		return 1;
+	}
+	ticks = seconds * 1000 / periodMs;
+	shardCount = (channels + shardSize - 1) / shardSize;
+	shards = cache_alloc(shardCount * sizeof(Shard));
+	for (unsigned s = 0; s < shardCount; s++)
+	{
+		shards[s].first = s * shardSize;
+		shards[s].count = (s == shardCount - 1) ? channels - s * shardSize : shardSize;
+		shards[s].buttons = cache_alloc(shards[s].count * sizeof(HostButton));
+		shards[s].models = cache_alloc(shards[s].count * sizeof(SwitchModel));
+		shards[s].presses = cache_alloc(shards[s].count * sizeof(uint32_t));
+		shard_reset(&shards[s], seed);
+	}
+
+	printf("%u switches, %u shards, %u ticks of %ums\n", channels, shardCount, ticks, periodMs);
+	reference = reference_run(shards, shardCount, ticks, periodMs);
+	printf("threads,seconds,updates_per_s,speedup,efficiency,result\n");
+	for (unsigned threads = 1; ; threads *= 2)  // 1, 2, 4 ... and finally maxThreads
+	{
+		double taken;
+		if (threads > maxThreads) threads = maxThreads;
+		for (unsigned s = 0; s < shardCount; s++) shard_reset(&shards[s], seed);
+		taken = threaded_run(shards, shardCount, threads, ticks, periodMs, &checksum);
+		if (threads == 1) base = taken;
+		printf("%u,%.3f,%.3g,%.2f,%.0f%%,%s\n", threads, taken, (double)channels * ticks / taken, base / taken,
+			100 * base / taken / threads, (checksum == reference) ? "ok" : "MISMATCH");
+		if (checksum != reference) failed = 1;
+		if (threads == maxThreads) break;
+	}
+
+	for (unsigned s = 0; s < shardCount; s++)
+	{
+		free(shards[s].buttons);
+		free(shards[s].models);
+		free(shards[s].presses);
+	}
+	free(shards);
+	return failed;
+}
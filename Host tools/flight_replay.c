@@ -0,0 +1,152 @@
+/*********************************************************************
+ * flight_replay.c - replays a dump from flight_recorder.c through the library's debounce
+ *
+ * Created: 19/10/2026
+ * Author : agent
+ *
+ * Usage: flight_replay [options] [dump file]     reads stdin if no file is given
+ *   -g ms    flag presses shorter than this as ghosts (default 40, FLIGHT_GHOST_MS)
+ *   -r       also print every change of the raw samples, as a bit string with the first button on the left
+ *
+ * Prints one line per debounced edge:  <ms> <button> pressed|released [ghost <ms>]  then  <ms> trigger <reason>
+ * where the recorder was triggered.  The time is from the oldest sample in the dump.  The replay uses
+ * host_debounce.h, so it decides exactly as the library does - except that the histories from before the
+ * oldest sample have gone, so each button starts seeded from that first sample (as SEED_HISTORY does).
+ *
+ * Build: gcc -O2 -I"../Library files/n_button_V3" -o flight_replay flight_replay.c
+ *
+ **********************************************************************/
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include "host_debounce.h"
+
+// these match flight_recorder.h
+#define FLIGHT_VERSION 1
+#define FLIGHT_HEADER_SIZE 11
+#define FLIGHT_GHOST 1
+#define FLIGHT_REQUESTED 2
+
+#define MAX_BUTTONS 32
+
+static void print_sample(unsigned long long ms, uint32_t sample, unsigned buttons)
+{
+	printf("%llu raw ", ms);
+	for (unsigned i = 0; i < buttons; i++) putchar((sample >> i) & 1 ? '1' : '0');
+	putchar('\n');
+}
+
+int main(int argc, char *argv[])
+{
+	FILE *in = stdin;
+	uint8_t header[FLIGHT_HEADER_SIZE];
+	unsigned ghostMs = 40;
+	int raw = 0;
+	int opt;
+
+	while ((opt = getopt(argc, argv, "g:r")) != -1)
+	{
+		switch (opt)
+		{
+			case 'g': ghostMs = (unsigned)strtoul(optarg, NULL, 0); break;
+			case 'r': raw = 1; break;
+			default:
+				fprintf(stderr, "usage: %s [-g ms] [-r] [dump file]\n", argv[0]);
+				return 1;
+		}
+	}
+	if (optind < argc && !(in = fopen(argv[optind], "rb")))
+	{
+		perror(argv[optind]);
+		return 1;
+	}
+
+	if (fread(header, 1, sizeof(header), in) != sizeof(header) || header[0] != 'F' || header[1] != 'R')
+	{
+		fprintf(stderr, "not a flight recorder dump\n");
+		return 1;
+	}
+	if (header[2] != FLIGHT_VERSION)
+	{
+		fprintf(stderr, "dump version %u, this replays version %u\n", header[2], FLIGHT_VERSION);
+		return 1;
+	}
+	unsigned buttons = header[3];
+	unsigned firstId = header[4];
+	unsigned period = header[5];
+	unsigned reason = header[6];
+	unsigned maskBytes = header[7];
+	unsigned after = header[8];
+	unsigned runs = header[9] | (header[10] << 8);
+	if (buttons == 0 || buttons > MAX_BUTTONS || period == 0 || maskBytes == 0 || maskBytes > 4)
+	{
+		fprintf(stderr, "bad dump header\n");
+		return 1;
+	}
+
+	HostButton button[MAX_BUTTONS];
+	unsigned long long pressedAt[MAX_BUTTONS];
+	unsigned long long samples = 0;
+	unsigned long ghosts = 0;
+	uint32_t last = 0;
+
+	for (unsigned r = 0; r < runs; r++)
+	{
+		uint8_t run[5];
+		if (fread(run, 1, maskBytes + 1, in) != maskBytes + 1)
+		{
+			fprintf(stderr, "dump cut short after %u of %u runs\n", r, runs);
+			break;
+		}
+		uint32_t sample = 0;
+		for (unsigned b = maskBytes; b--; ) sample = (sample << 8) | run[b];
+		unsigned count = run[maskBytes];
+
+		if (samples == 0)  // seed from the first sample
+		{
+			for (unsigned i = 0; i < buttons; i++)
+			{
+				button[i].down = (sample >> i) & 1;
+				button[i].history = button[i].down ? 0xFF : 0x00;
+				pressedAt[i] = 0;
+			}
+		}
+		if (raw && (samples == 0 || sample != last)) print_sample(samples * period, sample, buttons);
+		last = sample;
+
+		for (unsigned k = 0; k < count; k++, samples++)
+		{
+			unsigned long long ms = samples * period;
+			for (unsigned i = 0; i < buttons; i++)
+			{
+				uint8_t event = host_debounce_sample(&button[i], (sample >> i) & 1);
+				if (event == BUTTON_PRESSED)
+				{
+					pressedAt[i] = ms;
+					printf("%llu %u pressed\n", ms, firstId + i);
+				} else if (event == BUTTON_RELEASED)
+				{
+					unsigned long long held = ms - pressedAt[i];
+					if (held < ghostMs)
+					{
+						printf("%llu %u released ghost %llu\n", ms, firstId + i, held);
+						ghosts++;
+					} else
+					{
+						printf("%llu %u released\n", ms, firstId + i);
+					}
+				}
+			}
+		}
+	}
+
+	if (reason && samples >= after)
+	{
+		printf("%llu trigger %s\n", (samples - after) * period,
+			(reason == FLIGHT_GHOST) ? "ghost" : (reason == FLIGHT_REQUESTED) ? "requested" : "unknown");
+	}
+	fprintf(stderr, "%u buttons, %llu samples of %ums in %u runs, %lu ghost presses\n", buttons, samples, period, runs, ghosts);
+	return 0;
+}
@@ -0,0 +1,12 @@
+// avr/eeprom.h - host check stand in for the avr-libc header
+#ifndef AVR_STUB_EEPROM_H
+#define AVR_STUB_EEPROM_H
+
+#include <stddef.h>
+
+// host_check.h keeps the EEPROM in a RAM array
+#define EEMEM
+void eeprom_read_block(void *dst, const void *src, size_t size);
+void eeprom_update_block(const void *src, void *dst, size_t size);
+
+#endif //AVR_STUB_EEPROM_H
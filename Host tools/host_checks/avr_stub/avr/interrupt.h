@@ -0,0 +1,10 @@
+// avr/interrupt.h - host check stand in for the avr-libc header
+#ifndef AVR_STUB_INTERRUPT_H
+#define AVR_STUB_INTERRUPT_H
+
+// an ISR is a plain function the check calls, and there is nothing to turn on or off
+#define ISR(v, ...) void v(void); void v(void)
+#define sei() ((void)0)
+#define cli() ((void)0)
+
+#endif //AVR_STUB_INTERRUPT_H
@@ -0,0 +1,111 @@
+/*********************************************************************
+ * avr/io.h - stand in for the avr-libc header, so the library builds on a PC for the host checks
+ *
+ * Created: 19/10/2026
+ * Author : agent
+ *
+ * Every register is a byte of avrRegs[], at its ATmega328P data space address, so a check sets a pin by
+ * writing PIND and reads back what the library did to PORTD or EIMSK.  The 16 bit registers are kept in
+ * avrRegs16[].  host_check.h defines both.  Only the registers and bits the library uses are here.
+ *
+ **********************************************************************/
+#ifndef AVR_STUB_IO_H
+#define AVR_STUB_IO_H
+
+#include <stdint.h>
+
+extern volatile uint8_t avrRegs[256];
+extern volatile uint16_t avrRegs16[16];
+#define _R(a) (avrRegs[a])
+#define PINB _R(0x23)
+#define DDRB _R(0x24)
+#define PORTB _R(0x25)
+#define PINC _R(0x26)
+#define DDRC _R(0x27)
+#define PORTC _R(0x28)
+#define PIND _R(0x29)
+#define DDRD _R(0x2A)
+#define PORTD _R(0x2B)
+#define TIFR0 _R(0x35)
+#define TIFR1 _R(0x36)
+#define TIFR2 _R(0x37)
+#define PCIFR _R(0x3B)
+#define EIFR _R(0x3C)
+#define EIMSK _R(0x3D)
+#define GPIOR0 _R(0x3E)
+#define EECR _R(0x3F)
+#define EEDR _R(0x40)
+#define EEAR avrRegs16[0]
+#define GTCCR _R(0x43)
+#define TCCR0A _R(0x44)
+#define TCCR0B _R(0x45)
+#define TCNT0 _R(0x46)
+#define OCR0A _R(0x47)
+#define OCR0B _R(0x48)
+#define SREG _R(0x5F)
+#define PCICR _R(0x68)
+#define EICRA _R(0x69)
+#define PCMSK0 _R(0x6B)
+#define PCMSK1 _R(0x6C)
+#define PCMSK2 _R(0x6D)
+#define TIMSK0 _R(0x6E)
+#define TIMSK1 _R(0x6F)
+#define TIMSK2 _R(0x70)
+#define TCCR1A _R(0x80)
+#define TCCR1B _R(0x81)
+#define TCNT1 avrRegs16[1]
+#define OCR1A avrRegs16[2]
+#define TCCR2A _R(0xB0)
+#define TCCR2B _R(0xB1)
+#define TCNT2 _R(0xB2)
+#define OCR2A _R(0xB3)
+#define UCSR0A _R(0xC0)
+#define UCSR0B _R(0xC1)
+#define UCSR0C _R(0xC2)
+#define UBRR0 avrRegs16[3]
+#define UBRR0H _R(0xC5)
+#define UBRR0L _R(0xC4)
+#define UDR0 _R(0xC6)
+#define SPMCSR _R(0x57)
+#define OCF0A 1
+#define OCF2A 1
+#define OCIE2A 1
+#define WGM21 1
+#define CS21 1
+#define OCF0B 2
+#define OCIE0A 1
+#define OCIE0B 2
+#define TOV1 0
+#define CS10 0
+#define CS11 1
+#define WGM01 1
+#define CS00 0
+#define CS01 1
+#define UDRE0 5
+#define U2X0 1
+#define TXEN0 3
+#define RXEN0 4
+#define UDRIE0 5
+#define UCSZ00 1
+#define UCSZ01 2
+#define INT0 0
+#define INT1 1
+#define INTF0 0
+#define INTF1 1
+#define ISC00 0
+#define ISC01 1
+#define ISC10 2
+#define ISC11 3
+#define PCIE0 0
+#define PCIE1 1
+#define PCIE2 2
+#define EERE 0
+#define EEPE 1
+#define EEMPE 2
+#define PB0 0
+#define PD2 2
+#define PD3 3
+#define PD4 4
+#define E2END 0x3FF
+
+#endif //AVR_STUB_IO_H
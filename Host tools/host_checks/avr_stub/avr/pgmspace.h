@@ -0,0 +1,16 @@
+// avr/pgmspace.h - host check stand in for the avr-libc header
+#ifndef AVR_STUB_PGMSPACE_H
+#define AVR_STUB_PGMSPACE_H
+
+#include <stdint.h>
+#include <string.h>
+
+// flash is just memory on a PC
+#define PROGMEM
+#define PSTR(s) (s)
+#define pgm_read_byte(p) (*(const uint8_t *)(p))
+#define pgm_read_word(p) (*(const uint16_t *)(p))
+#define pgm_read_ptr(p) (*(void *const *)(p))
+#define memcpy_P memcpy
+
+#endif //AVR_STUB_PGMSPACE_H
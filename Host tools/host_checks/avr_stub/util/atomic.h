@@ -0,0 +1,10 @@
+// util/atomic.h - host check stand in for the avr-libc header
+#ifndef AVR_STUB_ATOMIC_H
+#define AVR_STUB_ATOMIC_H
+
+// the checks run the ISRs by hand, so nothing can get in part way through
+#define ATOMIC_RESTORESTATE
+#define ATOMIC_FORCEON
+#define ATOMIC_BLOCK(type) for (int atomicOnce = 1; atomicOnce; atomicOnce = 0)
+
+#endif //AVR_STUB_ATOMIC_H
@@ -0,0 +1,15 @@
+// util/crc16.h - host check stand in for the avr-libc header
+#ifndef AVR_STUB_CRC16_H
+#define AVR_STUB_CRC16_H
+
+#include <stdint.h>
+
+// the same polynomial (0xA001) as the avr-libc version
+static inline uint16_t _crc16_update(uint16_t crc, uint8_t a)
+{
+	crc ^= a;
+	for (int i = 0; i < 8; i++) crc = (crc & 1) ? (crc >> 1) ^ 0xA001 : (crc >> 1);
+	return crc;
+}
+
+#endif //AVR_STUB_CRC16_H
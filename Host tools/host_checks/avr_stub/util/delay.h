@@ -0,0 +1,8 @@
+// util/delay.h - host check stand in for the avr-libc header
+#ifndef AVR_STUB_DELAY_H
+#define AVR_STUB_DELAY_H
+
+#define _delay_ms(ms) ((void)0)
+#define _delay_us(us) ((void)0)
+
+#endif //AVR_STUB_DELAY_H
@@ -0,0 +1,131 @@
+/*********************************************************************
+ * check_button_bank.cpp - the C++17 ButtonBank in button_bank.hpp against the C library's rules
+ *
+ * Created: 19/10/2026
+ * Author : agent
+ *
+ * Build with -std=c++17.  The pins are driven at random for 200000 ticks while a reference history is kept
+ * here, shifted once every sample period, and every query of the bank is compared with the library's rules
+ * written out longhand - the press and release compares and the all 1's and all 0's tests.  Then the button
+ * modes: the pull ups, an active high input and the seeding of a button held at power on.
+ *
+ **********************************************************************/
+
+#include <cstdio>
+#include "button_bank.hpp"
+
+static unsigned checkFailures;
+#define CHECK(test) do { if (!(test)) { checkFailures++; std::printf("%s:%d: failed: %s\n", __FILE__, __LINE__, #test); } } while (0)
+
+// the ATmega328 port addresses
+#define PINB_ADDRESS 0x23
+#define DDRB_ADDRESS 0x24
+#define PORTB_ADDRESS 0x25
+#define PINC_ADDRESS 0x26
+#define DDRC_ADDRESS 0x27
+#define PORTC_ADDRESS 0x28
+#define PIND_ADDRESS 0x29
+#define DDRD_ADDRESS 0x2A
+#define PORTD_ADDRESS 0x2B
+
+using Io = debounce::HostIo;
+
+struct PanelButtons
+{
+	static constexpr debounce::ButtonPin pins[] = {{4, PIND_ADDRESS, PORTD_ADDRESS, DDRD_ADDRESS},
+		{5, PIND_ADDRESS, PORTD_ADDRESS, DDRD_ADDRESS}, {5, PINB_ADDRESS, PORTB_ADDRESS, DDRB_ADDRESS}};
+	static constexpr uint8_t samplePeriod = 5;
+};
+
+struct MixedInputs
+{
+	static constexpr debounce::ButtonPin pins[] = {{4, PIND_ADDRESS, PORTD_ADDRESS, DDRD_ADDRESS},
+		{2, PINC_ADDRESS, PORTC_ADDRESS, DDRC_ADDRESS, BUTTON_ACTIVE_HIGH},
+		{3, PINC_ADDRESS, PORTC_ADDRESS, DDRC_ADDRESS, BUTTON_NO_PULL}};
+	static constexpr uint8_t samplePeriod = 1;
+};
+
+// the library's rules, as n_button_debounce_v3.c had them before the tables
+static uint8_t reference_class(uint8_t h)
+{
+	uint8_t c = 0;
+	if (h == 0xFF) c |= HISTORY_DOWN;
+	if (h == 0x00) c |= HISTORY_UP;
+	if ((h & PRESSED_MASK) == PRESSED_PATTERN) c |= HISTORY_PRESSED;
+	if ((h & RELEASED_MASK) == RELEASED_PATTERN) c |= HISTORY_RELEASED;
+	if (h != 0xFF && h != 0x00) c |= HISTORY_BOUNCING;
+	return c;
+}
+
+static void check_against_rules()
+{
+	debounce::ButtonBank<PanelButtons> panel;
+	uint8_t reference[3] = {0x00, 0x00, 0xFF};
+	unsigned seed = 1, wrong = 0, presses = 0;
+
+	Io::ports[PIND_ADDRESS] = 0xFF;
+	Io::ports[PINB_ADDRESS] = 0xDF;  // button 2 held at power on
+	panel.start();
+	CHECK((Io::ports[DDRD_ADDRESS] & 0x30) == 0x00 && (Io::ports[PORTD_ADDRESS] & 0x30) == 0x30);   // inputs, pull ups on
+	CHECK(panel.down(2) && !panel.pressed(2));
+	CHECK(panel.up(0) && !panel.down(0));
+
+	for (long ms = 0; ms < 200000; ms++)
+	{
+		if (ms % 37 == 0)
+		{
+			seed = seed * 1103515245 + 12345;
+			Io::ports[PIND_ADDRESS] = ((seed >> 16) & 0x30) | 0xCF;
+		}
+		if (ms % PanelButtons::samplePeriod == PanelButtons::samplePeriod - 1)
+		{
+			for (int i = 0; i < 3; i++)
+			{
+				const debounce::ButtonPin &pin = PanelButtons::pins[i];
+				reference[i] = (uint8_t)(reference[i] << 1) | (((Io::ports[pin.inputPort] >> pin.terminal) & 1) ^ 1);
+			}
+		}
+		panel.tick();
+		for (int i = 0; i < 3; i++)
+		{
+			uint8_t c = reference_class(reference[i]);
+			if (panel.history(i) != reference[i]) wrong++;
+			if (panel.button_class(i) != c) wrong++;
+			if (panel.pressed(i) != ((c & HISTORY_PRESSED) != 0)) wrong++;
+			if (panel.released(i) != ((c & HISTORY_RELEASED) != 0)) wrong++;
+			if (panel.down(i) != ((c & HISTORY_DOWN) != 0)) wrong++;
+			if (panel.up(i) != ((c & HISTORY_UP) != 0)) wrong++;
+		}
+		if (ms % PanelButtons::samplePeriod == PanelButtons::samplePeriod - 1) presses += panel.pressed(0);
+	}
+	CHECK(wrong == 0);
+	CHECK(presses > 0);
+}
+
+static void check_modes()
+{
+	debounce::ButtonBank<MixedInputs> inputs;
+
+	Io::ports[PIND_ADDRESS] = 0xFF;
+	Io::ports[PINC_ADDRESS] = 0x00;  // the active high sensor off, and the driven input on
+	Io::ports[PORTC_ADDRESS] = 0xFF;
+	Io::ports[PORTD_ADDRESS] = 0x00;
+	inputs.start();
+	CHECK(Io::ports[PORTD_ADDRESS] == 0x10);   // the pull up on the plain button only
+	CHECK(Io::ports[PORTC_ADDRESS] == 0xF3);   // and taken off the other two
+	CHECK(inputs.up(0) && inputs.up(1) && inputs.down(2));
+
+	Io::ports[PINC_ADDRESS] = 0x0C;            // the sensor on, the driven input off
+	for (int i = 0; i < 8; i++) inputs.tick();
+	CHECK(inputs.down(1) && inputs.up(2) && inputs.up(0));
+}
+
+int main()
+{
+	check_against_rules();
+	check_modes();
+
+	if (checkFailures) std::printf("%u failed\n", checkFailures);
+	else std::printf("ok\n");
+	return checkFailures ? 1 : 0;
+}
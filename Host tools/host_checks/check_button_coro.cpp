@@ -0,0 +1,129 @@
+/*********************************************************************
+ * check_button_coro.cpp - the C++20 button coroutines in button_coro.hpp
+ *
+ * Created: 19/10/2026
+ * Author : agent
+ *
+ * Build with -std=c++20.  Every co_await result goes into a variable first, so it is safe to build with
+ * BUTTON_CORO_GCC12_OK on g++ 12.  Checks the waits and time limits, that nothing comes from the heap, that
+ * sleep_ms(0) doesn't sleep, that a task destroyed by another one while both wait for the same event is never
+ * resumed, and that tasks are resumed in the order they waited.
+ *
+ **********************************************************************/
+
+#include <cstdio>
+#include <cstdlib>
+#include <optional>
+#include "button_coro.hpp"
+
+static unsigned checkFailures;
+#define CHECK(test) do { if (!(test)) { checkFailures++; std::printf("%s:%d: failed: %s\n", __FILE__, __LINE__, #test); } } while (0)
+
+// count any use of the heap
+static int heapUsed;
+void *operator new(std::size_t size) { heapUsed++; return std::malloc(size); }
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete(void *p, std::size_t) noexcept { std::free(p); }
+
+struct Event { uint8_t button, type; uint16_t time; };
+static const Event press0 = {0, debounce::BUTTON_PRESSED, 0};
+static const Event press1 = {1, debounce::BUTTON_PRESSED, 0};
+static const Event press2 = {2, debounce::BUTTON_PRESSED, 0};
+
+static int unlocked, timeouts, blinks, zeroSleeps, killerRan, victimRan, order[3], orderCount;
+static std::optional<debounce::ButtonTask> victim;
+
+debounce::ButtonTask unlock_sequence()
+{
+	for (;;)
+	{
+		co_await debounce::await_press(0);
+		bool inTime = co_await debounce::await_press(1, 500);
+		if (inTime) unlocked++;
+		else timeouts++;
+	}
+}
+
+debounce::ButtonTask blinker()
+{
+	for (int i = 0; i < 3; i++)
+	{
+		co_await debounce::sleep_ms(100);
+		blinks++;
+	}
+}
+
+debounce::ButtonTask zero_sleeper()
+{
+	for (int i = 0; i < 3; i++)
+	{
+		co_await debounce::sleep_ms(0);
+		zeroSleeps++;
+	}
+}
+
+debounce::ButtonTask killer()
+{
+	for (;;)
+	{
+		co_await debounce::await_press(0);
+		killerRan++;
+		victim.reset();   // destroys the other task while it is still waiting for this same event
+	}
+}
+
+debounce::ButtonTask waiter()
+{
+	for (;;)
+	{
+		co_await debounce::await_press(0);
+		victimRan++;
+	}
+}
+
+debounce::ButtonTask in_order(int id)
+{
+	co_await debounce::await_press(2);
+	order[orderCount++] = id;
+}
+
+int main()
+{
+	auto &loop = debounce::button_loop();
+
+	{
+		auto task = unlock_sequence();
+		auto blink = blinker();
+		CHECK(task.valid() && blink.valid());
+		loop.post(press0);
+		loop.post(press0);      // used up by the wait for button 1?  no - it waits for 1, so this is ignored
+		loop.advance(100);
+		loop.post(press1);      // in time
+		loop.post(press0);
+		loop.advance(700);      // too late
+		loop.advance(1000);
+		loop.post(press1);      // nobody waiting for it
+		CHECK(unlocked == 1 && timeouts == 1);
+		CHECK(blinks == 3 && blink.done());
+	}
+	loop.advance(5000);         // the tasks were destroyed while they waited, so must be off the list
+	CHECK(heapUsed == 0);
+
+	auto sleeper = zero_sleeper();
+	CHECK(zeroSleeps == 3 && sleeper.done());
+
+	auto kill = killer();
+	victim.emplace(waiter());
+	loop.post(press0);
+	CHECK(killerRan == 1 && victimRan == 0 && !victim.has_value());
+	loop.post(press0);
+	CHECK(killerRan == 2 && victimRan == 0);
+
+	auto a = in_order(1), b = in_order(2), c = in_order(3);
+	loop.post(press2);
+	CHECK(orderCount == 3 && order[0] == 1 && order[1] == 2 && order[2] == 3);
+
+	if (checkFailures) std::printf("%u failed\n", checkFailures);
+	else std::printf("ok\n");
+	return checkFailures ? 1 : 0;
+}
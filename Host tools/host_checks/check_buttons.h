@@ -0,0 +1,8 @@
+// The buttons the host checks use, given to the library with -DBUTTON_CONFIG='"check_buttons.h"'.  The same
+// pins as btn[] in n_button_debounce_v3.c - D4, D5, D6 and B5 - as an array the checks can set
+Buttons btn[n] = {
+	{0x04, &PIND, &PORTD, &DDRD},
+	{0x05, &PIND, &PORTD, &DDRD},
+	{0x06, &PIND, &PORTD, &DDRD},
+	{0x05, &PINB, &PORTB, &DDRB},
+};
@@ -0,0 +1,8 @@
+// The buttons of the BUTTON_MODES check - the pins of check_buttons.h with one of each mode: a plain button,
+// an active high sensor, an active low input without the pull up and an active high one without it
+Buttons btn[n] = {
+	{0x04, &PIND, &PORTD, &DDRD},
+	{0x05, &PIND, &PORTD, &DDRD, BUTTON_ACTIVE_HIGH},
+	{0x06, &PIND, &PORTD, &DDRD, BUTTON_NO_PULL},
+	{0x05, &PINB, &PORTB, &DDRB, BUTTON_ACTIVE_HIGH | BUTTON_NO_PULL},
+};
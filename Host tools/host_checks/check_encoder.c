@@ -0,0 +1,61 @@
+/*********************************************************************
+ * check_encoder.c - a quadrature encoder that rests with both contacts open counts each click once, in the click
+ *
+ * Created: 19/10/2026
+ * Author : agent
+ *
+ * Build with ENCODERS set to 1.  The encoder is on PC2 and PC3 with the detent state of encoder.h's example,
+ * 0b00 - both pins high.  Turning one click walks the four states and back to rest; the count must only move
+ * when it gets there, not half a click early, and a turn that goes half way and comes back counts nothing.
+ *
+ **********************************************************************/
+
+#include "n_button_debounce_v3.c"
+#include "encoder.c"
+#include "host_check.h"
+
+const EncoderConfig knobConfig = {&PINC, &PORTC, &DDRC, 2, 3, 4, 0b00};
+Encoder knob = {.config = &knobConfig};
+
+// set the contacts, 1 = closed (pin low), and let a tick sample them
+static void contacts(uint8_t a, uint8_t b)
+{
+	PINC = (PINC | 0x0C) & ~((a << 2) | (b << 3));
+	TIMER0_COMPA_vect();
+}
+
+int main(void)
+{
+	PIND = 0xFF;
+	PINB = 0xFF;
+	PINC = 0xFF;  // resting in a click, both contacts open
+	start_debounce();
+	add_encoder(&knob);
+	CHECK((PORTC & 0x0C) == 0x0C && (DDRC & 0x0C) == 0);
+
+	contacts(1, 0);
+	contacts(1, 1);
+	CHECK(get_encoder_count(&knob) == 0);
+	contacts(0, 1);
+	CHECK(get_encoder_count(&knob) == 0);   // three quarters of the way, still not in the click
+	contacts(0, 0);
+	int16_t click = get_encoder_count(&knob);
+	CHECK(click == 1 || click == -1);
+
+	// half way and back again
+	contacts(1, 0);
+	contacts(1, 1);
+	contacts(1, 0);
+	contacts(0, 0);
+	CHECK(get_encoder_count(&knob) == click);
+
+	// the other way
+	contacts(0, 1);
+	contacts(1, 1);
+	contacts(1, 0);
+	contacts(0, 0);
+	CHECK(get_encoder_count(&knob) == 0);
+	CHECK(get_encoder_errors(&knob) == 0);
+
+	return check_done();
+}
@@ -0,0 +1,186 @@
+/*********************************************************************
+ * check_flight.c - the flight recorder: its dump, the triggers, and the ring wrapping
+ *
+ * Created: 19/10/2026
+ * Author : agent
+ *
+ * Build with FLIGHT_RECORDER, BUTTON_EVENTS and DEBOUNCE_TRACE set to 1.  Three recordings:
+ *   - presses, bounces and chatter, then freeze_flight_recorder().  Given a directory, this one's dump is
+ *     written to flight.dump in it and the library's own events over the same samples to flight_events.out,
+ *     in flight_replay's format with the time from the first recorded sample, so run_checks.sh can replay the
+ *     dump and insist the replay finds exactly the same edges
+ *   - a ghost press, which must freeze the recorder FLIGHT_AFTER_SAMPLES samples later
+ *   - more changes than the ring holds, which must keep the newest FLIGHT_RECORDER_RUNS runs
+ *
+ **********************************************************************/
+
+#include "n_button_debounce_v3.c"
+#include "flight_recorder.c"
+#include "host_check.h"
+
+#define CHECK_PERIOD 5
+
+static FILE *eventFile;
+static uint8_t recorded;           // 1 once the recording has its first sample
+static uint8_t frozen;             // 1 once the recorder has stopped taking samples
+static uint32_t firstSampleMs, lastSampleMs;
+
+// called after each sample has gone to the recorder - keeps when the recorded samples were
+void debounce_trace(const DebounceBank *bank)
+{
+	if (frozen) return;
+	if (!recorded)
+	{
+		recorded = 1;
+		firstSampleMs = milliCtr;
+	}
+	lastSampleMs = milliCtr;
+	frozen = (flight_recorder_state() == FLIGHT_FROZEN);
+}
+
+static void restart(void)
+{
+	restart_flight_recorder();
+	recorded = 0;
+	frozen = 0;
+}
+
+static void ticks(int count)
+{
+	ButtonEvent event;
+
+	while (count--)
+	{
+		TIMER0_COMPA_vect();
+		while (get_button_event(&event))
+		{
+			if (eventFile && recorded && (uint16_t)(event.time - (uint16_t)firstSampleMs) <= lastSampleMs - firstSampleMs)
+			{
+				fprintf(eventFile, "%u %u %s\n", (uint16_t)(event.time - (uint16_t)firstSampleMs), event.button,
+					(event.type == BUTTON_PRESSED) ? "pressed" : "released");
+			}
+		}
+	}
+}
+
+static void check_requested(const char *directory)
+{
+	uint8_t dump[FLIGHT_DUMP_MAX];
+	char path[512];
+
+	if (directory)
+	{
+		snprintf(path, sizeof(path), "%s/flight_events.out", directory);
+		eventFile = fopen(path, "w");
+		CHECK(eventFile != 0);
+	}
+
+	restart();
+	ticks(1000);
+	PIND &= ~(1<<5);                         // a clean press
+	ticks(200);
+	PIND |= (1<<5);
+	ticks(500);
+	PINB &= ~(1<<5);                         // a bouncy one
+	ticks(2);
+	PINB |= (1<<5);
+	ticks(3);
+	PINB &= ~(1<<5);
+	ticks(300);
+	PINB |= (1<<5);
+	ticks(400);
+	for (int i = 0; i < 10; i++)             // chatter that never settles long enough to press
+	{
+		PIND ^= (1<<6);
+		ticks(3);
+	}
+	ticks(300);
+	CHECK(flight_recorder_state() == FLIGHT_RECORDING);
+
+	freeze_flight_recorder();
+	ticks((FLIGHT_AFTER_SAMPLES - 1) * CHECK_PERIOD);
+	CHECK(flight_recorder_state() == FLIGHT_TRIGGERED);
+	ticks(CHECK_PERIOD);
+	CHECK(flight_recorder_state() == FLIGHT_FROZEN);
+	ticks(500);                              // nothing more goes in
+	CHECK(lastSampleMs - firstSampleMs < 3100);
+
+	uint16_t size = dump_flight_recorder(dump, sizeof(dump));
+	CHECK(size > FLIGHT_HEADER_SIZE && size <= FLIGHT_DUMP_MAX);
+	CHECK(dump[0] == 'F' && dump[1] == 'R' && dump[2] == FLIGHT_VERSION && dump[3] == n);
+	CHECK(dump[5] == CHECK_PERIOD && dump[6] == FLIGHT_REQUESTED && dump[8] == FLIGHT_AFTER_SAMPLES);
+	CHECK(size == FLIGHT_HEADER_SIZE + dump[9] * (sizeof(ButtonMask) + 1));
+	CHECK(dump_flight_recorder(dump, size - 1) == 0);   // a buffer too small gets nothing
+
+	// every sample is in the runs
+	unsigned long samples = 0;
+	for (uint16_t r = 0; r < dump[9]; r++) samples += dump[FLIGHT_HEADER_SIZE + r * (sizeof(ButtonMask) + 1) + sizeof(ButtonMask)];
+	CHECK(samples == (lastSampleMs - firstSampleMs) / CHECK_PERIOD + 1);
+
+	if (directory)
+	{
+		fclose(eventFile);
+		eventFile = 0;
+		snprintf(path, sizeof(path), "%s/flight.dump", directory);
+		FILE *dumpFile = fopen(path, "wb");
+		CHECK(dumpFile && fwrite(dump, 1, size, dumpFile) == size);
+		if (dumpFile) fclose(dumpFile);
+	}
+}
+
+static void check_ghost(void)
+{
+	uint8_t dump[FLIGHT_DUMP_MAX];
+
+	restart();
+	ticks(500);
+	PIND &= ~(1<<4);                         // a press the debounce takes, let go again too soon
+	ticks(32);
+	PIND |= (1<<4);
+	ticks(50);
+	CHECK(flight_recorder_state() == FLIGHT_TRIGGERED);
+	ticks(FLIGHT_AFTER_SAMPLES * CHECK_PERIOD);
+	CHECK(flight_recorder_state() == FLIGHT_FROZEN);
+	CHECK(dump_flight_recorder(dump, sizeof(dump)) > FLIGHT_HEADER_SIZE);
+	CHECK(dump[6] == FLIGHT_GHOST && dump[8] == FLIGHT_AFTER_SAMPLES);
+
+	// a press held longer than FLIGHT_GHOST_MS doesn't trigger it
+	restart();
+	PIND &= ~(1<<4);
+	ticks(32 + FLIGHT_GHOST_MS);
+	PIND |= (1<<4);
+	ticks(FLIGHT_AFTER_SAMPLES * CHECK_PERIOD);
+	CHECK(flight_recorder_state() == FLIGHT_RECORDING);
+}
+
+static void check_wrap(void)
+{
+	uint8_t dump[FLIGHT_DUMP_MAX];
+
+	restart();
+	for (int i = 0; i < FLIGHT_RECORDER_RUNS * 2; i++)
+	{
+		PIND ^= (1<<6);
+		ticks(CHECK_PERIOD);
+	}
+	PIND |= (1<<6);
+	ticks(CHECK_PERIOD);
+	CHECK(dump_flight_recorder(dump, sizeof(dump)) == FLIGHT_DUMP_MAX);
+	CHECK(dump[6] == 0 && dump[9] == FLIGHT_RECORDER_RUNS);
+	// the newest run, last in the dump, is the latest sample - button 2 up
+	CHECK((dump[FLIGHT_DUMP_MAX - 1 - sizeof(ButtonMask)] & (1<<2)) == 0);
+}
+
+int main(int argc, char *argv[])
+{
+	PIND = 0xFF;
+	PINB = 0xFF;
+	start_debounce();
+	set_bank_sample_period(&defaultBank, CHECK_PERIOD);
+	start_flight_recorder(&defaultBank);
+
+	check_requested((argc > 1) ? argv[1] : 0);
+	check_ghost();
+	check_wrap();
+	return check_done();
+}
@@ -0,0 +1,49 @@
+/*********************************************************************
+ * check_lut_nbutton.c - the n button v3 classification table against the compares it replaced
+ *
+ * Created: 19/10/2026
+ * Author : agent
+ *
+ * Before history_lut.h each query compared the history itself - pressed was 0x3F, released 0xE0, down 0xFF
+ * and up 0x00.  Every one of the 256 histories must classify the same way through the table.
+ *
+ * Built with CHECK_OVERRIDE set to 1 it sets PRESSED_PATTERN and RELEASED_MASK only, as a project would with
+ * compiler symbols - those two must take effect and the other two rules keep their defaults.
+ *
+ **********************************************************************/
+
+#ifndef CHECK_OVERRIDE
+#define CHECK_OVERRIDE 0
+#endif
+
+#if CHECK_OVERRIDE
+#define PRESSED_PATTERN 0b00011111   // pressed after 5 down samples instead of 6
+#define RELEASED_MASK 0b11110000     // and released on the last 4 samples only
+#endif
+
+#include "n_button_debounce_v3.c"
+#include "host_check.h"
+
+#if CHECK_OVERRIDE
+#define OLD_PRESSED(h) ((h) == 0x1F)
+#define OLD_RELEASED(h) (((h) & 0xF0) == 0xE0)
+#else
+#define OLD_PRESSED(h) ((h) == 0x3F)
+#define OLD_RELEASED(h) ((h) == 0xE0)
+#endif
+
+int main(void)
+{
+	CHECK(PRESSED_MASK == 0xFF && RELEASED_PATTERN == 0xE0);
+	for (unsigned h = 0; h < 256; h++)
+	{
+		uint8_t history = h;
+		uint8_t old = ((history == 0xFF) ? HISTORY_DOWN : 0) | ((history == 0x00) ? HISTORY_UP : 0) |
+			(OLD_PRESSED(history) ? HISTORY_PRESSED : 0) | (OLD_RELEASED(history) ? HISTORY_RELEASED : 0);
+		uint8_t mask = HISTORY_DOWN | HISTORY_UP | HISTORY_PRESSED | HISTORY_RELEASED;
+		CHECK((button_class(&history) & mask) == old);
+		CHECK(is_button_pressed(&history) == OLD_PRESSED(history));
+		CHECK(is_button_released(&history) == OLD_RELEASED(history));
+	}
+	return check_done();
+}
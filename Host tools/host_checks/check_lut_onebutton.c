@@ -0,0 +1,45 @@
+/*********************************************************************
+ * check_lut_onebutton.c - the one button v1 classification table against the compares it replaced
+ *
+ * Created: 19/10/2026
+ * Author : agent
+ *
+ * The one button library's rules are pressed 0x7F and released (history & 0xCF) == 0xC0, with down 0xFF and
+ * up 0x00.  Every one of the 256 histories must classify the same way through the table.  Then a press and
+ * release through the ISR, polled every sample: is_button_released() must report the release once, though the
+ * rule matches three samples running, and leave the history cleared.
+ *
+ **********************************************************************/
+
+#include "one_button_debounce_v1.c"
+#include "host_check.h"
+
+int main(void)
+{
+	for (unsigned h = 0; h < 256; h++)
+	{
+		uint8_t history = h;
+		uint8_t old = ((history == 0xFF) ? HISTORY_DOWN : 0) | ((history == 0x00) ? HISTORY_UP : 0) |
+			((history == 0x7F) ? HISTORY_PRESSED : 0) | (((history & 0xCF) == 0xC0) ? HISTORY_RELEASED : 0);
+		uint8_t mask = HISTORY_DOWN | HISTORY_UP | HISTORY_PRESSED | HISTORY_RELEASED;
+		CHECK((button_class(&history) & mask) == old);
+	}
+
+	int presses = 0, releases = 0;
+	PIND = 0xFF;
+	start_oneButtonDebounce();
+	for (int t = 0; t < 60; t++)
+	{
+		if (t == 10) PIND &= ~(1<<button);
+		if (t == 30) PIND |= (1<<button);
+		TIMER0_COMPA_vect();
+		presses += is_button_pressed(&button_history);
+		if (is_button_released(&button_history))
+		{
+			releases++;
+			CHECK(button_history == 0 && t == 33);   // the 4th up sample
+		}
+	}
+	CHECK(presses == 1 && releases == 1);
+	return check_done();
+}
@@ -0,0 +1,102 @@
+/*********************************************************************
+ * check_modes.c - BUTTON_MODES: each input's polarity and pull up, with and without DEBOUNCE_INLINE
+ *
+ * Created: 19/10/2026
+ * Author : agent
+ *
+ * Build with BUTTON_MODES and BUTTON_EVENTS set to 1 and the buttons in check_buttons_modes.h - one of each
+ * mode.  The pull ups must go on the plain button only, each input must be pressed at its own level, and
+ * seeding must take an active high input that is already on as down, with no press.  A second bank has its
+ * ports mixed up - B, D, B - so each port word is read again when the port changes and XORed with its own mask.
+ *
+ **********************************************************************/
+
+#include "n_button_debounce_v3.c"
+#include "host_check.h"
+
+static void ticks(int count)
+{
+	while (count--) TIMER0_COMPA_vect();
+}
+
+// the events waiting, one bit per button and type - bit button * 2 for pressed, button * 2 + 1 for released
+static uint16_t take_events(void)
+{
+	ButtonEvent event;
+	uint16_t seen = 0;
+
+	while (get_button_event(&event)) seen |= 1 << (event.button * 2 + event.type - BUTTON_PRESSED);
+	return seen;
+}
+
+static uint8_t down_mask(void)
+{
+	uint8_t down = 0;
+
+	for (uint8_t i = 0; i < n; i++) if (is_button_down(&button_history[i])) down |= 1 << i;
+	return down;
+}
+
+#define PRESS(button) (1 << ((button) * 2))
+#define RELEASE(button) (1 << ((button) * 2 + 1))
+
+const Buttons mixedPins[3] = {
+	{0x00, &PINB, &PORTB, &DDRB, BUTTON_ACTIVE_HIGH},
+	{0x07, &PIND, &PORTD, &DDRD},
+	{0x01, &PINB, &PORTB, &DDRB},
+};
+const DebounceBankConfig mixedConfig = {mixedPins, 3, 1, 8, historyClass};  // events numbered from 8
+DEBOUNCE_BANK(mixedBank, mixedConfig, 3);
+
+int main(void)
+{
+	PORTD = 0x00;
+	PORTB = 0xFF;
+	PIND = 0xFF & ~(1<<5);  // every input off - the active high ones low
+	PINB = 0x00;
+	start_debounce();
+	CHECK((PORTD & 0x70) == 0x10);   // the pull up on the plain button only
+	CHECK(!(PORTB & 0x20));          // and never on an active high input, even with the bit set before
+	CHECK((DDRD & 0x70) == 0 && !(DDRB & 0x20));
+
+	ticks(60);
+	CHECK(take_events() == 0 && down_mask() == 0);
+
+	PIND |= (1<<5);                  // the active high inputs on
+	PINB |= (1<<5);
+	ticks(60);
+	CHECK(take_events() == (PRESS(1) | PRESS(3)) && down_mask() == 0x0A);
+
+	PIND &= ~((1<<4) | (1<<6));      // and the active low ones
+	ticks(60);
+	CHECK(take_events() == (PRESS(0) | PRESS(2)) && down_mask() == 0x0F);
+
+	PIND = (PIND | (1<<4) | (1<<6)) & ~(1<<5);
+	PINB &= ~(1<<5);
+	ticks(60);
+	CHECK(take_events() == (RELEASE(0) | RELEASE(1) | RELEASE(2) | RELEASE(3)) && down_mask() == 0);
+
+	// seeding reads each input at its own level
+	PIND |= (1<<5);
+	seed_debounce_bank(&defaultBank);
+	CHECK(down_mask() == 0x02);
+	ticks(60);
+	CHECK(take_events() == 0 && down_mask() == 0x02);
+
+	// the mixed bank - B0 active high, D7 and B1 active low, all off to start with
+	PINB = (PINB & ~(1<<0)) | (1<<1);
+	PIND |= (1<<7);
+	add_debounce_bank(&mixedBank);
+	ticks(60);
+	CHECK(mixedBank.history[0] == 0x00 && mixedBank.history[1] == 0x00 && mixedBank.history[2] == 0x00);
+	PINB |= (1<<0);                  // B0 on
+	PIND &= ~(1<<7);                 // and D7
+	ticks(60);
+	CHECK(mixedBank.history[0] == 0xFF && mixedBank.history[1] == 0xFF && mixedBank.history[2] == 0x00);
+	PINB &= ~((1<<0) | (1<<1));      // B0 off, B1 on
+	ticks(60);
+	CHECK(mixedBank.history[0] == 0x00 && mixedBank.history[1] == 0xFF && mixedBank.history[2] == 0xFF);
+	take_events();
+
+	return check_done();
+}
@@ -0,0 +1,78 @@
+/*********************************************************************
+ * check_noblock.c - DEBOUNCE_NOBLOCK: ticks that come in during the bank work are caught up, never lost
+ *
+ * Created: 19/10/2026
+ * Author : agent
+ *
+ * Build with BUTTON_EVENTS and DEBOUNCE_TRACE set to 1, with or without DEBOUNCE_NOBLOCK.  With CHECK_NEST
+ * set to 1 the trace hook, which runs part way through the bank work with interrupts back on, calls the timer
+ * ISR once or twice itself, as a tick arriving then would.  Every tick must still have its banks sampled
+ * exactly once, and the busy flag and the backlog must end clear.  Without CHECK_NEST the events are printed
+ * as a hash, and run_checks.sh insists DEBOUNCE_NOBLOCK prints the same as the blocking build.
+ *
+ **********************************************************************/
+
+#include "n_button_debounce_v3.c"
+#include "host_check.h"
+
+#ifndef CHECK_NEST
+#define CHECK_NEST 0
+#endif
+
+#define CHECK_PERIOD 5
+
+static long samples, nests;
+static uint8_t nesting;
+
+void debounce_trace(const DebounceBank *bank)
+{
+	samples++;
+	if (CHECK_NEST && !nesting && samples % 3 == 0)
+	{
+		nesting = 1;
+		nests++;
+		TIMER0_COMPA_vect();
+		if (samples % 2 == 0) TIMER0_COMPA_vect();
+		nesting = 0;
+	}
+}
+
+int main(void)
+{
+	unsigned seed = 7;
+	unsigned long hash = 0;
+	long events = 0;
+	ButtonEvent event;
+
+	PIND = 0xFF;
+	PINB = 0xFF;
+	start_debounce();
+	set_bank_sample_period(&defaultBank, CHECK_PERIOD);
+	samples = 0;
+	milliCtr = 0;
+
+	for (long t = 0; milliCtr < 200000; t++)
+	{
+		if (t % 53 == 0)
+		{
+			seed = seed * 1103515245 + 12345;
+			PIND = ((seed >> 16) & 0x70) | 0x8F;
+			PINB = ((seed >> 20) & 0x20) | 0xDF;
+		}
+		TIMER0_COMPA_vect();
+		while (get_button_event(&event))
+		{
+			events++;
+			hash = hash * 31 + event.button * 3 + event.type;
+		}
+	}
+
+	CHECK(samples == (long)(milliCtr / CHECK_PERIOD));
+	CHECK(events > 0);
+#if DEBOUNCE_NOBLOCK
+	CHECK(!debounceBusy && !tickBacklog);
+#endif
+	if (CHECK_NEST) CHECK(nests > 0);
+	else printf("events %ld hash %lx\n", events, hash);
+	return check_done();
+}
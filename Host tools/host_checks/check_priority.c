@@ -0,0 +1,115 @@
+/*********************************************************************
+ * check_priority.c - the priority inputs: first edge reporting, the lockout, polarity and tuned lockouts
+ *
+ * Created: 19/10/2026
+ * Author : agent
+ *
+ * Build with PRIORITY_INPUTS, BUTTON_EVENTS, BUTTON_MODES and DEBOUNCE_PARAMS set to 1, and the default
+ * PRIORITY_SOURCES.  The pin interrupts are called by hand straight after the pin changes, as the hardware
+ * would.  An input on a pin change interrupt must be turned away, as that vector has no ISR.
+ *
+ **********************************************************************/
+
+#include "n_button_debounce_v3.c"
+#include "priority_input.c"
+#include "debounce_params.c"
+#include "host_check.h"
+
+static uint8_t handled;  // the last type the handler was called with
+static uint64_t handledAt;
+
+static void stop_now(uint8_t type)
+{
+	handled = type;
+	handledAt = milliCtr;
+}
+
+static void ticks(int count)
+{
+	while (count--) TIMER0_COMPA_vect();
+}
+
+const PriorityConfig estopConfig = {&PIND, &PORTD, &DDRD, 2, PRIORITY_INT0, 20, 30, stop_now};
+const PriorityConfig sensorConfig = {&PIND, &PORTD, &DDRD, 3, PRIORITY_INT1, 0, 29, 0, BUTTON_ACTIVE_HIGH};
+PriorityInput estop = {.config = &estopConfig};
+PriorityInput sensor = {.config = &sensorConfig};
+const PriorityConfig spareConfig = {&PINB, &PORTB, &DDRB, 0, PRIORITY_PCINT_B, 10, 28};  // PCINT0 has no ISR here
+PriorityInput spare = {.config = &spareConfig};
+
+int main(void)
+{
+	ButtonEvent event;
+
+	PIND = 0xF7;  // D3, the active high sensor, off
+	PINB = 0xFF;
+	start_debounce();
+	CHECK(add_priority_input(&estop));
+	CHECK(add_priority_input(&sensor));
+	CHECK(EIMSK == 0x03);
+	PCICR = 0;
+	PCMSK0 = 0;
+	CHECK(!add_priority_input(&spare));   // not in PRIORITY_SOURCES - nothing may be switched on
+	CHECK(PCICR == 0 && PCMSK0 == 0 && firstInput == &sensor);
+	CHECK(!is_priority_down(&estop) && !is_priority_down(&sensor));
+	CHECK((PORTD & 0x0C) == 0x04);   // the pull up on the active low input only
+	CHECK(sensor.lockoutMs == 1);    // a lockout of 0 is taken as 1
+
+	// the first edge is reported in the pin interrupt itself, before any tick
+	ticks(10);
+	PIND &= ~0x04;
+	INT0_vect();
+	CHECK(handled == BUTTON_PRESSED && handledAt == 10);
+	CHECK(is_priority_down(&estop));
+	CHECK(!(EIMSK & 0x01));
+	CHECK(get_button_event(&event) && event.button == 30 && event.type == BUTTON_PRESSED);
+
+	// bounces while locked out are ignored, and the interrupt comes back on after 20ms
+	PIND |= 0x04;
+	INT0_vect();
+	PIND &= ~0x04;
+	INT0_vect();
+	ticks(19);
+	CHECK(!(EIMSK & 0x01));
+	ticks(1);
+	CHECK(EIMSK & 0x01);
+	CHECK(!get_button_event(&event));
+
+	// a short press that starts and ends inside a lockout is reported when the lockout ends
+	PIND |= 0x04;
+	INT0_vect();
+	CHECK(handled == BUTTON_RELEASED);
+	ticks(3);
+	PIND &= ~0x04;
+	ticks(30);
+	CHECK(is_priority_down(&estop));
+	PIND |= 0x04;
+	INT0_vect();   // still locked out from the change the tick reported
+	ticks(30);
+	CHECK(!is_priority_down(&estop));
+
+	// the active high input isn't read inverted, and a 0 lockout doesn't leave it deaf
+	while (get_button_event(&event));
+	PIND |= 0x08;
+	INT1_vect();
+	CHECK(is_priority_down(&sensor));
+	CHECK(get_button_event(&event) && event.button == 29 && event.type == BUTTON_PRESSED);
+	PIND &= ~0x08;
+	INT1_vect();   // bounced straight back, while locked out
+	CHECK(is_priority_down(&sensor));
+	ticks(1);      // the tick finds it changed, reports it and locks out again
+	CHECK(!is_priority_down(&sensor) && !(EIMSK & 0x02));
+	ticks(1);
+	CHECK(EIMSK & 0x02);
+	PIND |= 0x08;
+	INT1_vect();
+	CHECK(is_priority_down(&sensor));
+
+	// tuned lockouts go into the parameter block
+	set_priority_lockout(&estop, 0);
+	CHECK(estop.lockoutMs == 1 && debounceParams.priorityLockout[0] == 1);
+	set_priority_lockout(&sensor, 15);
+	CHECK(debounceParams.priorityLockout[1] == 15);
+	CHECK(param_priority_lockout(1, 40) == 15 && param_priority_lockout(5, 40) == 40);
+
+	return check_done();
+}
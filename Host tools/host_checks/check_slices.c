@@ -0,0 +1,95 @@
+/*********************************************************************
+ * check_slices.c - ISR_SLICE: each button still sampled once a period, and the same events as unsliced
+ *
+ * Created: 19/10/2026
+ * Author : agent
+ *
+ * Build with BUTTON_EVENTS and BUTTON_CHORDS set to 1, and with ISR_SLICE 1, 3 or left out.  First every
+ * pin is toggled every tick, so each sample changes its button's history - the history must change exactly
+ * once every sample period, whichever tick of the period the button's slice falls on.  Then the pins are
+ * driven at random for 300000 ticks and the totals of each event are printed; run_checks.sh insists the
+ * sliced builds print the same totals as the unsliced one.  The pins only change on the tick that starts a
+ * period: a change between two slices is seen a period apart by their buttons, which can rightly change a
+ * chord.  The times of the events move with the slice phase, so they aren't compared.
+ *
+ **********************************************************************/
+
+#include "n_button_debounce_v3.c"
+#include "host_check.h"
+
+#define CHECK_PERIOD 5
+
+const ChordConfig service = {(1<<0)|(1<<3), 200, CHORD_ANY_ORDER, 0, n};  // its events carry n, the first number after the buttons
+Chord serviceChord = {.config = &service};
+
+static void check_once_a_period(void)
+{
+	uint8_t last[n];
+	long lastChange[n];
+	int wrongGap = 0, changes[n] = {0};
+
+	for (uint8_t i = 0; i < n; i++)
+	{
+		last[i] = button_history[i];
+		lastChange[i] = -1;
+	}
+	for (long t = 0; t < 1000; t++)
+	{
+		PIND ^= 0x70;
+		PINB ^= 0x20;
+		TIMER0_COMPA_vect();
+		for (uint8_t i = 0; i < n; i++)
+		{
+			if (button_history[i] == last[i]) continue;
+			if (lastChange[i] >= 0 && t - lastChange[i] != CHECK_PERIOD) wrongGap++;
+			lastChange[i] = t;
+			last[i] = button_history[i];
+			changes[i]++;
+		}
+	}
+	CHECK(wrongGap == 0);
+	// the first sample of a slice, and the last, can fall either side of the ends of the run
+	for (uint8_t i = 0; i < n; i++) CHECK(changes[i] >= 1000 / CHECK_PERIOD - 2 && changes[i] <= 1000 / CHECK_PERIOD);
+}
+
+static void print_event_totals(void)
+{
+	unsigned long totals[n + 1][BUTTON_CHORD_END + 1] = {{0}};
+	unsigned seed = 7;
+	unsigned long periods = 0;
+	ButtonEvent event;
+
+	for (long t = 0; t < 300000; t++)
+	{
+		// on the tick that starts a period, and every 53 periods - long enough, now and then, to hold the chord
+		if (defaultBank.divider == 1 && ++periods % 53 == 0)
+		{
+			seed = seed * 1103515245 + 12345;
+			PIND = ((seed >> 16) & 0x70) | 0x8F;
+			PINB = ((seed >> 20) & 0x20) | 0xDF;
+		}
+		TIMER0_COMPA_vect();
+		while (get_button_event(&event))
+		{
+			CHECK(event.button <= n && event.type <= BUTTON_CHORD_END);
+			if (event.button <= n && event.type <= BUTTON_CHORD_END) totals[event.button][event.type]++;
+		}
+	}
+	for (uint8_t b = 0; b <= n; b++)
+		printf("button %u: pressed %lu released %lu chord %lu chord end %lu\n", b, totals[b][BUTTON_PRESSED],
+			totals[b][BUTTON_RELEASED], totals[b][BUTTON_CHORD], totals[b][BUTTON_CHORD_END]);
+	CHECK(totals[0][BUTTON_PRESSED] > 0 && totals[n][BUTTON_CHORD] > 0);
+}
+
+int main(void)
+{
+	PIND = 0xFF;
+	PINB = 0xFF;
+	start_debounce();
+	set_bank_sample_period(&defaultBank, CHECK_PERIOD);
+	add_chord(&defaultBank, &serviceChord);
+
+	check_once_a_period();
+	print_event_totals();
+	return check_done();
+}
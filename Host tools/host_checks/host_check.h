@@ -0,0 +1,46 @@
+/*********************************************************************
+ * host_check.h - the bits every host check needs, after the library's .c files are included
+ *
+ * Created: 19/10/2026
+ * Author : agent
+ *
+ * A check #includes the library .c files it tests (so it can see their static variables), then this, then
+ * drives the pins through PINB/PIND and calls TIMER0_COMPA_vect() for each 1ms tick.  CHECK() counts a
+ * failure and says where, and check_done() prints "ok" or the number of failures and gives main()'s exit
+ * status, so run_checks.sh only has to look at that.
+ *
+ **********************************************************************/
+#ifndef HOST_CHECK_H
+#define HOST_CHECK_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+
+volatile uint8_t avrRegs[256];
+volatile uint16_t avrRegs16[16];
+
+// the EEMEM variables are ordinary variables on a PC, so they are the EEPROM - all 0 to start with, which
+// is as good as blank for a block with a version number and a CRC
+void eeprom_read_block(void *dst, const void *src, size_t size)
+{
+	memcpy(dst, src, size);
+}
+
+void eeprom_update_block(const void *src, void *dst, size_t size)
+{
+	memcpy(dst, src, size);
+}
+
+static unsigned checkFailures;
+
+#define CHECK(test) do { if (!(test)) { checkFailures++; printf("%s:%d: failed: %s\n", __FILE__, __LINE__, #test); } } while (0)
+
+static int check_done(void)
+{
+	if (checkFailures) printf("%u failed\n", checkFailures);
+	else printf("ok\n");
+	return checkFailures ? 1 : 0;
+}
+
+#endif //HOST_CHECK_H
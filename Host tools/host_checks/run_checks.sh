@@ -0,0 +1,120 @@
+#!/bin/sh
+#********************************************************************
+# run_checks.sh - builds and runs the host checks of the debounce libraries
+#
+# Created: 19/10/2026
+# Author : agent
+#
+# Needs a host gcc and g++ (C++20 for the coroutine check).  Run it from anywhere:
+#   sh "Host tools/host_checks/run_checks.sh"
+#
+# The library is built for the PC against the stand in AVR headers in avr_stub/, with the buttons in
+# check_buttons.h, and each check drives the pins and the 1ms tick itself.  This checks the logic only -
+# nothing here says anything about the timing, size or behaviour of the code avr-gcc makes.
+#
+# Each check prints "ok" and exits 0, or prints what failed.  "same" runs two builds of one check and
+# insists their output is identical, eg that a new option decides exactly as the library did without it.
+# The exit status is the number of checks that failed.
+#
+#********************************************************************
+
+HERE=$(cd "$(dirname "$0")" && pwd)
+LIB="$HERE/../../Library files"
+OUT="${CHECK_OUT:-$HERE/build}"
+CC="${CC:-gcc}"
+CXX="${CXX:-g++}"
+NLIB="$LIB/n_button_V3"
+BUTTONS='-DBUTTON_CONFIG="check_buttons.h"'
+failed=0
+
+mkdir -p "$OUT"
+
+# build <name> <source> [compiler flags] - leaves $OUT/<name>
+build()
+{
+	name=$1; source=$2; shift 2
+	case "$source" in
+		*.cpp) "$CXX" -O1 -Wall -I"$HERE" "$@" -o "$OUT/$name" "$HERE/$source" ;;
+		*) "$CC" -std=gnu11 -O1 -Wall -DF_CPU=8000000UL -isystem "$HERE/avr_stub" -I"$HERE" "$@" \
+			-o "$OUT/$name" "$HERE/$source" ;;
+	esac
+}
+
+# check <name> <source> [compiler flags] - builds it and runs it, which must print ok
+check()
+{
+	name=$1
+	if build "$@" && "$OUT/$name" > "$OUT/$name.out" 2>&1 && [ "$(tail -n 1 "$OUT/$name.out")" = "ok" ]
+	then
+		echo "pass  $name"
+	else
+		echo "FAIL  $name"
+		sed 's/^/      /' "$OUT/$name.out" 2>/dev/null
+		failed=$((failed + 1))
+	fi
+}
+
+# same <name> <first build's output> <second build's output> - two runs that must have printed the same
+same()
+{
+	if cmp -s "$OUT/$2.out" "$OUT/$3.out"
+	then
+		echo "pass  $1"
+	else
+		echo "FAIL  $1 ($2 and $3 differ)"
+		failed=$((failed + 1))
+	fi
+}
+
+# the classification tables give the same answers as the compares they replaced
+check lut_nbutton check_lut_nbutton.c -I"$NLIB" "$BUTTONS"
+check lut_override check_lut_nbutton.c -I"$NLIB" "$BUTTONS" -DCHECK_OVERRIDE=1
+check lut_override_inline check_lut_nbutton.c -I"$NLIB" "$BUTTONS" -DCHECK_OVERRIDE=1 -DDEBOUNCE_INLINE=1
+check lut_onebutton check_lut_onebutton.c -I"$LIB/One_button_V1"
+
+# the encoders - a click counts when the encoder comes to rest in it
+check encoder check_encoder.c -I"$NLIB" "$BUTTONS" -DENCODERS=1
+
+# the priority inputs - first edge, lockout, polarity and tuned lockouts
+check priority check_priority.c -I"$NLIB" "$BUTTONS" -DPRIORITY_INPUTS=1 -DBUTTON_EVENTS=1 -DBUTTON_MODES=1 \
+	-DDEBOUNCE_PARAMS=1
+
+# BUTTON_MODES - the pull ups and each input's polarity, out of line and inline
+MODES='-DBUTTON_CONFIG="check_buttons_modes.h"'
+check modes check_modes.c -I"$NLIB" "$MODES" -DBUTTON_MODES=1 -DBUTTON_EVENTS=1
+check modes_inline check_modes.c -I"$NLIB" "$MODES" -DBUTTON_MODES=1 -DBUTTON_EVENTS=1 -DDEBOUNCE_INLINE=1
+
+# ISR_SLICE - each button sampled once a period, and the same event totals, chords included, as unsliced
+SLICES="-DBUTTON_EVENTS=1 -DBUTTON_CHORDS=1"
+check slices_off check_slices.c -I"$NLIB" "$BUTTONS" $SLICES
+check slices_1 check_slices.c -I"$NLIB" "$BUTTONS" $SLICES -DISR_SLICE=1
+check slices_3 check_slices.c -I"$NLIB" "$BUTTONS" $SLICES -DISR_SLICE=3
+same "slices_1 events" slices_off slices_1
+same "slices_3 events" slices_off slices_3
+
+# DEBOUNCE_NOBLOCK - a tick arriving during the bank work is caught up, and the events are unchanged
+NOBLOCK="-DBUTTON_EVENTS=1 -DDEBOUNCE_TRACE=1"
+check noblock_nested check_noblock.c -I"$NLIB" "$BUTTONS" $NOBLOCK -DDEBOUNCE_NOBLOCK=1 -DCHECK_NEST=1
+check noblock check_noblock.c -I"$NLIB" "$BUTTONS" $NOBLOCK -DDEBOUNCE_NOBLOCK=1
+check blocking check_noblock.c -I"$NLIB" "$BUTTONS" $NOBLOCK
+same "noblock events" blocking noblock
+
+# the flight recorder - the triggers and the ring, and flight_replay finds the library's own edges in a dump
+check flight check_flight.c -I"$NLIB" "$BUTTONS" -DFLIGHT_RECORDER=1 -DBUTTON_EVENTS=1 -DDEBOUNCE_TRACE=1
+if build flight_replay ../flight_replay.c -I"$NLIB" && "$OUT/flight" "$OUT" > /dev/null
+then
+	"$OUT/flight_replay" "$OUT/flight.dump" 2> /dev/null | grep -v trigger > "$OUT/flight_replay.out"
+fi
+same "flight replay" flight_events flight_replay
+check flight_noblock check_flight.c -I"$NLIB" "$BUTTONS" -DFLIGHT_RECORDER=1 -DBUTTON_EVENTS=1 -DDEBOUNCE_TRACE=1 \
+	-DDEBOUNCE_NOBLOCK=1
+check flight_slices check_flight.c -I"$NLIB" "$BUTTONS" -DFLIGHT_RECORDER=1 -DBUTTON_EVENTS=1 -DDEBOUNCE_TRACE=1 \
+	-DISR_SLICE=3
+
+# the C++17 ButtonBank - the same decisions as the C rules, and the button modes
+check button_bank check_button_bank.cpp -std=c++17 -I"$NLIB"
+
+# the C++20 button coroutines - time limits, no heap, sleep_ms(0), destroyed and resumed in order
+check button_coro check_button_coro.cpp -std=c++20 -DBUTTON_CORO_GCC12_OK -I"$HERE/.."
+
+exit $failed
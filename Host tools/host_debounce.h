@@ -0,0 +1,56 @@
+/*********************************************************************
+ * host_debounce.h - the n button v3 debounce for host tools
+ *
+ * Created: 19/10/2026
+ * Author : agent
+ *
+ * Header only.  Uses the same history shift, debounce rules (n_button_debounce_v3_inline.h) and
+ * classification table (history_lut.h) as the library, and decides presses and releases the same way the
+ * library's ISR does for BUTTON_EVENTS, so a host tool sees exactly what the AVR would.  Build with
+ *   -I"../Library files/n_button_V3"
+ *
+ **********************************************************************/
+
+#ifndef HOST_DEBOUNCE_H
+#define HOST_DEBOUNCE_H
+
+#include <stdint.h>
+#include "n_button_debounce_v3_inline.h"
+#include "history_lut.h"
+
+// these match n_button_debounce_v3.h
+#define BUTTON_PRESSED 1
+#define BUTTON_RELEASED 2
+
+#define HOST_CLASSIFY(h) HISTORY_CLASSIFY(h, PRESSED_MASK, PRESSED_PATTERN, RELEASED_MASK, RELEASED_PATTERN)
+static const uint8_t hostHistoryClass[256] = { HISTORY_TABLE(HOST_CLASSIFY) };
+
+typedef struct
+{
+	uint8_t history;  // button_history[] in the library
+	uint8_t down;     // the debounced state
+} HostButton;
+
+// shift one sample (1 = pressed) into the button and return BUTTON_PRESSED, BUTTON_RELEASED or 0
+static inline uint8_t host_debounce_sample(HostButton *button, uint8_t pressed)
+{
+	uint8_t cls;
+
+	button->history = debounce_shift(button->history, pressed);
+	cls = hostHistoryClass[button->history];
+	if (!button->down)
+	{
+		if (cls & (HISTORY_PRESSED | HISTORY_DOWN))
+		{
+			button->down = 1;
+			return BUTTON_PRESSED;
+		}
+	} else if (cls & (HISTORY_RELEASED | HISTORY_UP))
+	{
+		button->down = 0;
+		return BUTTON_RELEASED;
+	}
+	return 0;
+}
+
+#endif //HOST_DEBOUNCE_H
@@ -0,0 +1,100 @@
+/*********************************************************************
+ * telemetry_decode.c - turns the button event frames from uart_telemetry.c back into text
+ *
+ * Created: 19/10/2026
+ * Author : agent
+ *
+ * Usage: telemetry_decode [capture file]     reads stdin if no file is given, eg
+ *        stty -F /dev/ttyUSB0 38400 raw && telemetry_decode < /dev/ttyUSB0
+ *
+ * Prints one line per frame:  <ms> <button> pressed|released|chord|chord_end   or   <ms> dropped <count>
+ * The time is the sum of the frame deltas, so it starts at the ms of the first event.  Bytes that
+ * don't make a valid frame are skipped until the next sync byte and counted as bad at the end.
+ *
+ * Build: gcc -O2 -o telemetry_decode telemetry_decode.c
+ *
+ **********************************************************************/
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+
+// these match uart_telemetry.h and n_button_debounce_v3.h
+#define TELEMETRY_SYNC 0xA5
+#define TELEMETRY_DROPS 7
+#define TELEMETRY_NO_BUTTON 31
+#define TELEMETRY_FRAME_SIZE 5
+#define BUTTON_PRESSED 1
+#define BUTTON_RELEASED 2
+#define BUTTON_CHORD 3
+#define BUTTON_CHORD_END 4
+
+int main(int argc, char *argv[])
+{
+	FILE *in = stdin;
+	uint8_t frame[TELEMETRY_FRAME_SIZE];
+	unsigned have = 0;
+	unsigned long bad = 0;
+	unsigned long long now = 0;
+	int c;
+
+	if (argc > 1 && !(in = fopen(argv[1], "rb")))
+	{
+		perror(argv[1]);
+		return 1;
+	}
+
+	while ((c = getc(in)) != EOF)
+	{
+		frame[have++] = (uint8_t)c;
+		if (frame[0] != TELEMETRY_SYNC)
+		{
+			have = 0;
+			bad++;
+			continue;
+		}
+		if (have < TELEMETRY_FRAME_SIZE) continue;
+
+		if ((frame[1] ^ frame[2] ^ frame[3]) != frame[4])
+		{
+			// not a frame after all - look for the next sync byte in what we have
+			uint8_t *sync = memchr(frame + 1, TELEMETRY_SYNC, TELEMETRY_FRAME_SIZE - 1);
+			unsigned keep = sync ? (unsigned)(frame + TELEMETRY_FRAME_SIZE - sync) : 0;
+			bad += TELEMETRY_FRAME_SIZE - keep;
+			memmove(frame, frame + TELEMETRY_FRAME_SIZE - keep, keep);
+			have = keep;
+			continue;
+		}
+		have = 0;
+
+		static const char *names[] = {"", "pressed", "released", "chord", "chord_end"};
+		uint8_t type = frame[1] >> 5;
+		uint8_t button = frame[1] & 0x1F;
+		uint16_t value = frame[2] | (frame[3] << 8);
+
+		switch (type)
+		{
+			case BUTTON_PRESSED:
+			case BUTTON_RELEASED:
+			case BUTTON_CHORD:
+			case BUTTON_CHORD_END:
+				if (button == TELEMETRY_NO_BUTTON)  // reserved for the drops frames - not from uart_telemetry.c
+				{
+					printf("%llu bad button %u\n", now, button);
+					break;
+				}
+				now += value;
+				printf("%llu %u %s\n", now, button, names[type]);
+				break;
+			case TELEMETRY_DROPS:
+				printf("%llu dropped %u\n", now, value);
+				break;
+			default:
+				printf("%llu %u type%u %u\n", now, button, type, value);
+				break;
+		}
+		fflush(stdout);
+	}
+	if (bad) fprintf(stderr, "%lu bad bytes skipped\n", bad);
+	return 0;
+}
@@ -0,0 +1,149 @@
+/*********************************************************************
+ * vcd_trace.c - writes the raw samples, history bytes and debounced state of the buttons to a VCD file
+ *
+ * Created: 19/10/2026
+ * Author : agent
+ *
+ * See vcd_trace.h.  Each button has 3 signals - raw, history and debounced - with the VCD ids made from
+ * button * 3 + signal written in base 94 from '!'.
+ *
+ **********************************************************************/
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include "vcd_trace.h"
+
+enum { SIGNAL_RAW, SIGNAL_HISTORY, SIGNAL_DOWN };
+
+
+static void vcd_flush(VcdTrace *trace)
+{
+	fwrite(trace->buffer, 1, trace->used, trace->file);
+	trace->used = 0;
+}
+
+
+// room for at least need more bytes in the buffer
+static char *vcd_reserve(VcdTrace *trace, size_t need)
+{
+	if (trace->used + need > VCD_BUFFER_SIZE) vcd_flush(trace);
+	return trace->buffer + trace->used;
+}
+
+
+static size_t vcd_id(char *out, unsigned button, unsigned signal)
+{
+	unsigned k = button * 3 + signal;
+	size_t len = 0;
+	do
+	{
+		out[len++] = '!' + k % 94;
+		k /= 94;
+	} while (k);
+	return len;
+}
+
+
+static void vcd_bit(VcdTrace *trace, unsigned button, unsigned signal, uint8_t value)
+{
+	char *p = vcd_reserve(trace, 8);
+	size_t len = 0;
+	p[len++] = value ? '1' : '0';
+	len += vcd_id(p + len, button, signal);
+	p[len++] = '\n';
+	trace->used += len;
+}
+
+
+static void vcd_byte(VcdTrace *trace, unsigned button, uint8_t value)
+{
+	char *p = vcd_reserve(trace, 16);
+	size_t len = 0;
+	p[len++] = 'b';
+	for (int b = 7; b >= 0; b--) p[len++] = ((value >> b) & 1) ? '1' : '0';
+	p[len++] = ' ';
+	len += vcd_id(p + len, button, SIGNAL_HISTORY);
+	p[len++] = '\n';
+	trace->used += len;
+}
+
+
+int vcd_trace_open(VcdTrace *trace, const char *path, const char names[][VCD_NAME_SIZE], unsigned buttons)
+{
+	char id[4];
+
+	if (buttons > VCD_MAX_BUTTONS) buttons = VCD_MAX_BUTTONS;
+	memset(trace, 0, sizeof(*trace));
+	if (!(trace->file = fopen(path, "w")))
+	{
+		perror(path);
+		return -1;
+	}
+	trace->buttons = buttons;
+	fprintf(trace->file, "$version n button v3 vcd_trace $end\n$timescale 1 us $end\n$scope module buttons $end\n");
+	for (unsigned i = 0; i < buttons; i++)
+	{
+		char name[VCD_NAME_SIZE];
+		if (names) snprintf(name, sizeof(name), "%s", names[i]);
+		else snprintf(name, sizeof(name), "btn%u", i);
+		fprintf(trace->file, "$scope module %s $end\n", name);
+		id[vcd_id(id, i, SIGNAL_RAW)] = 0;
+		fprintf(trace->file, "$var wire 1 %s raw $end\n", id);
+		id[vcd_id(id, i, SIGNAL_HISTORY)] = 0;
+		fprintf(trace->file, "$var wire 8 %s history $end\n", id);
+		id[vcd_id(id, i, SIGNAL_DOWN)] = 0;
+		fprintf(trace->file, "$var wire 1 %s debounced $end\n$upscope $end\n", id);
+	}
+	fprintf(trace->file, "$upscope $end\n$enddefinitions $end\n#0\n$dumpvars\n");
+	for (unsigned i = 0; i < buttons; i++)  // everything starts at 0, like the library
+	{
+		vcd_bit(trace, i, SIGNAL_RAW, 0);
+		vcd_byte(trace, i, 0);
+		vcd_bit(trace, i, SIGNAL_DOWN, 0);
+	}
+	memcpy(vcd_reserve(trace, 6), "$end\n", 5);
+	trace->used += 5;
+	trace->timeWritten = 1;
+	return 0;
+}
+
+
+void vcd_trace_time(VcdTrace *trace, uint64_t timeNs)
+{
+	if (timeNs != trace->time)
+	{
+		trace->time = timeNs;
+		trace->timeWritten = 0;
+	}
+}
+
+
+void vcd_trace_button(VcdTrace *trace, unsigned button, uint8_t history, uint8_t down)
+{
+	if (button >= trace->buttons) return;
+	if ((history == trace->history[button]) && (down == trace->down[button])) return;  // the usual case
+
+	if (!trace->timeWritten)
+	{
+		char *p = vcd_reserve(trace, 24);
+		trace->used += sprintf(p, "#%llu\n", (unsigned long long)(trace->time / 1000));
+		trace->timeWritten = 1;
+	}
+	if ((history ^ trace->history[button]) & 0x01) vcd_bit(trace, button, SIGNAL_RAW, history & 0x01);
+	if (history != trace->history[button]) vcd_byte(trace, button, history);
+	if (down != trace->down[button]) vcd_bit(trace, button, SIGNAL_DOWN, down);
+	trace->history[button] = history;
+	trace->down[button] = down;
+}
+
+
+int vcd_trace_close(VcdTrace *trace)
+{
+	int result;
+	if (!trace->file) return 0;
+	vcd_flush(trace);
+	result = fclose(trace->file);
+	trace->file = NULL;
+	return result ? -1 : 0;
+}
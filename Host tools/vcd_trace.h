@@ -0,0 +1,56 @@
+/*********************************************************************
+ * vcd_trace.h - writes the raw samples, history bytes and debounced state of the buttons to a VCD file
+ *
+ * Created: 19/10/2026
+ * Author : agent
+ *
+ * Open the result in GTKWave to see, for each button, the raw sample (1 = pressed), the button_history byte
+ * and the debounced state side by side.  Only changes are written, through a 64KB buffer, so a long run
+ * stays small and quick.
+ *
+ *   vcd_trace_open(&trace, "buttons.vcd", names, count);
+ *   each tick:  vcd_trace_time(&trace, timeNs);
+ *               for each button  vcd_trace_button(&trace, i, history, down);
+ *   vcd_trace_close(&trace);
+ *
+ * capture_debounce -t writes one for a capture replay.  To trace the library itself in a host build
+ * compile it with DEBOUNCE_TRACE=1 and supply its hook, which the ISR calls after sampling each bank:
+ *
+ *   void debounce_trace(const DebounceBank *bank)
+ *   {
+ *       vcd_trace_time(&trace, (uint64_t)milliCtr * 1000000);
+ *       for (uint8_t i = 0; i < bank->config->count; i++)
+ *           vcd_trace_button(&trace, bank->config->firstId + i, bank->history[i], bank->state[i].down);
+ *   }
+ *
+ **********************************************************************/
+
+#ifndef VCD_TRACE_H
+#define VCD_TRACE_H
+
+#include <stdio.h>
+#include <stdint.h>
+
+#define VCD_MAX_BUTTONS 64
+#define VCD_NAME_SIZE 32
+#define VCD_BUFFER_SIZE 65536
+
+typedef struct
+{
+	FILE *file;
+	unsigned buttons;
+	uint64_t time;            // ns
+	int timeWritten;          // the #time line for this time is out
+	uint8_t history[VCD_MAX_BUTTONS];
+	uint8_t down[VCD_MAX_BUTTONS];
+	size_t used;
+	char buffer[VCD_BUFFER_SIZE];
+} VcdTrace;
+
+// names may be NULL for btn0, btn1 ...  Returns 0, or -1 with a message on stderr
+int vcd_trace_open(VcdTrace *trace, const char *path, const char names[][VCD_NAME_SIZE], unsigned buttons);
+void vcd_trace_time(VcdTrace *trace, uint64_t timeNs);
+void vcd_trace_button(VcdTrace *trace, unsigned button, uint8_t history, uint8_t down);
+int vcd_trace_close(VcdTrace *trace);
+
+#endif //VCD_TRACE_H
@@ -21,12 +21,20 @@
 
 #include <avr/io.h>
 #include <avr/interrupt.h>
+#include <util/delay.h>
 #include <stdint.h>
 #include "one_button_debounce_v1.h"
 #include "BitManipulation.h"
+#include "history_lut.h"
 
 #define MASK 0b11001111
 
+// The debounce rules for this version - a press is 7 samples down after one up, a release is two samples down then
+// two up, ignoring the 2 bits in the middle (MASK).  The table holds every state of every possible history byte.
+#define V1_CLASSIFY(h) HISTORY_CLASSIFY(h, 0b11111111, 0b01111111, MASK, 0b11000000)
+
+const uint8_t historyClass[256] PROGMEM = { HISTORY_TABLE(V1_CLASSIFY) };
+
 
 
 //local variables
@@ -58,6 +66,13 @@ ISR(TIMER0_COMPA_vect)
 
 void start_oneButtonDebounce(void)
 {
+	CLEAR_BIT(DDRD, button);  //clear bit of switch to configure as input for button
+	SET_BIT(PORTD, button); //set bit of switch to turn on pullup resistor
+	// start the history from the pin as it is now, so a button held at power on is down straight away with no
+	// pressed edge on the way.  Wait for the pull up to charge the pin first
+	_delay_us(10);
+	button_history = read_button(PIND, button) ? 0xFF : 0x00;
+	
 	// start the Millis timer - on timer 0 counts 125, prescale 64, interrupt on compare overflow
 	//enable global interrupts
 	sei();
@@ -67,8 +82,6 @@ void start_oneButtonDebounce(void)
 	TCCR0A = 0x02; // set Timer/Counter Control Register A to "CTC mode"
 	TCCR0B = 0x03; // set Timer/Counter Control Register B, 64 prescaler
 	startCnt = milliCtr;
-	CLEAR_BIT(DDRD, button);  //clear bit of switch to configure as input for button
-	SET_BIT(PORTD, button); //set bit of switch to turn on pullup resistor
 }
 
 //read the button
@@ -88,27 +101,41 @@ void update_button(uint8_t *button_history)
 
 uint8_t is_button_pressed(uint8_t *button_history)
 {
-	return (*button_history == 0b01111111);
+	return (pgm_read_byte(&historyClass[*button_history]) & HISTORY_PRESSED) != 0;
 }
 
+// Unlike the other queries this one changes the history.  The release rule ignores the 2 middle bits (MASK), so
+// it matches on the 4th, 5th and 6th samples after the button goes up (0b11110000, 0b11100000 and 0b11000000) -
+// left alone a main loop polling every ms would see three releases.  So when it matches the history is cleared
+// to 0, "up", and it can only match again after the next press.  The price: call it from one place only, as a
+// second caller in the same sample gets 0, and is_button_down()/is_button_up() see the button as fully up
+// straight after a release.  The ISR can shift in a sample between the read and the clear, which loses that
+// one sample - it would have been up anyway, as the button has just been released.
 uint8_t is_button_released(uint8_t *button_history)
 {
 	uint8_t released = 0;
-	if ((*button_history & MASK) == 0b11000000)
+	if (pgm_read_byte(&historyClass[*button_history]) & HISTORY_RELEASED)
 	{
 		released = 1;
-		*button_history = 0b00000000;
+		*button_history = 0b00000000;  // so the same release isn't reported again on the next 2 samples
 	}
 	return released;
 }
 
 uint8_t is_button_down(uint8_t *button_history)
 {
-	return (*button_history == 0b11111111);
+	return (pgm_read_byte(&historyClass[*button_history]) & HISTORY_DOWN) != 0;
 }
 
 
 uint8_t is_button_up(uint8_t *button_history)
 {
-	return (*button_history == 0b00000000);
+	return (pgm_read_byte(&historyClass[*button_history]) & HISTORY_UP) != 0;
+}
+
+
+// every state of the button in one go - HISTORY_DOWN, HISTORY_UP, HISTORY_PRESSED, HISTORY_RELEASED, HISTORY_BOUNCING
+uint8_t button_class(uint8_t *button_history)
+{
+	return pgm_read_byte(&historyClass[*button_history]);
 }
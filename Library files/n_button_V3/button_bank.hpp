@@ -0,0 +1,205 @@
+/*************************************************************************************************************
+ * button_bank.hpp - the n button v3 debounce as a C++17 class template, for C++ firmware and host tests
+ *
+ * Created: 19/10/2026
+ * Author : agent
+ *
+ * Header only, and doesn't need n_button_debounce_v3.c.  The buttons of a ButtonBank are fixed at compile time
+ * by a config struct, so every pin address and bit is a constant the compiler can build into the sampling and
+ * the queries - there are no virtuals, no heap and no table of pins in RAM.  The code avr-gcc makes from it
+ * hasn't been looked at or timed yet.  The debounce itself is the history shift and the PRESSED_/RELEASED_ rules from
+ * n_button_debounce_v3_inline.h, so it decides exactly as the C library does.
+ *
+ *   struct PanelButtons
+ *   {
+ *       static constexpr debounce::ButtonPin pins[] = {{4, 0x29, 0x2B, 0x2A}, {5, 0x29, 0x2B, 0x2A}, {5, 0x23, 0x25, 0x24}};
+ *       static constexpr uint8_t samplePeriod = 5;   // ms, at one tick() per ms
+ *   };
+ *   debounce::ButtonBank<PanelButtons> panel;
+ *
+ *   ISR(TIMER0_COMPA_vect) { panel.tick(); }        // from your own 1ms timer
+ *   ...
+ *   panel.start();                                   // pull ups on, histories seeded from the pins
+ *   if (panel.pressed(0)) ...
+ *
+ * The pins are given as {pin number, input port, output port, data direction register}, the same as btn[] in
+ * n_button_debounce_v3.c, with the ports as their data space addresses (PIND is 0x29 on the ATmega328).  A fifth
+ * field, the mode, marks an active high input (BUTTON_ACTIVE_HIGH, which never gets the pull up) or an active low
+ * one without the pull up (BUTTON_NO_PULL).
+ *
+ * On a PC the ports can't be read, so host builds get HostIo for the port access instead (the second template
+ * argument, which can be your own) - it keeps the "ports" in an array that a test sets the pins in:
+ *
+ *   debounce::ButtonBank<PanelButtons> panel;
+ *   debounce::HostIo::ports[0x29] = 0xEF;   // pin D4 low - button 0 pressed
+ *   panel.sample();
+ *
+ * Build with -std=c++17 (avr-gcc 7 or later).
+ *
+ ************************************************************************************************************/
+#ifndef BUTTON_BANK_HPP
+#define BUTTON_BANK_HPP
+
+#include <stdint.h>
+#include "n_button_debounce_v3_inline.h"
+#include "history_lut.h"
+#ifdef __AVR__
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <util/delay.h>
+#endif
+
+#define BUTTON_BANK_SETTLE_US 10  // time for the pull ups to charge the pins before start() reads them
+
+namespace debounce
+{
+
+// where a button is connected - the same as Buttons in n_button_debounce_v3.h, with addresses as numbers so
+// the config can be constexpr
+struct ButtonPin
+{
+	uint8_t terminal;     // the pin number on the port
+	uint16_t inputPort;   // address of the PINx register
+	uint16_t outputPort;  // PORTx, for the pull up
+	uint16_t ddr;         // DDRx
+	uint8_t mode = 0;     // BUTTON_ACTIVE_HIGH and/or BUTTON_NO_PULL, 0 (or left out) for active low with the pull up
+};
+
+#ifdef __AVR__
+// the real ports - with a constant address each of these is one in/out or lds/sts instruction
+struct AvrIo
+{
+	static uint8_t read(uint16_t address) { return *reinterpret_cast<volatile uint8_t *>(address); }
+	static void set_bit(uint16_t address, uint8_t bit) { *reinterpret_cast<volatile uint8_t *>(address) |= (uint8_t)(1 << bit); }
+	static void clear_bit(uint16_t address, uint8_t bit) { *reinterpret_cast<volatile uint8_t *>(address) &= (uint8_t)~(1 << bit); }
+	static void settle() { _delay_us(BUTTON_BANK_SETTLE_US); }
+};
+typedef AvrIo DefaultIo;
+#else
+// pretend ports for host builds, at the same addresses - all 0xFF (pins high, nothing pressed) to start with
+struct HostIo
+{
+	struct Ports
+	{
+		uint8_t at[0x200];
+		uint8_t &operator[](uint16_t address) { return at[address]; }
+	};
+	static constexpr Ports all_high()
+	{
+		Ports p = {};
+		for (uint8_t &b : p.at) b = 0xFF;
+		return p;
+	}
+	static inline Ports ports = all_high();
+
+	static uint8_t read(uint16_t address) { return ports[address]; }
+	static void set_bit(uint16_t address, uint8_t bit) { ports[address] |= (uint8_t)(1 << bit); }
+	static void clear_bit(uint16_t address, uint8_t bit) { ports[address] &= (uint8_t)~(1 << bit); }
+	static void settle() {}
+};
+typedef HostIo DefaultIo;
+#endif
+
+
+template <class Config, class Io = DefaultIo>
+class ButtonBank
+{
+public:
+	static constexpr uint8_t count = sizeof(Config::pins) / sizeof(Config::pins[0]);
+	static constexpr uint8_t samplePeriod = Config::samplePeriod;
+	static_assert(count > 0, "a ButtonBank needs at least one pin");
+	static_assert(samplePeriod > 0, "the sample period is in ms and can't be 0");
+
+	// set the pins to inputs with their pull ups on, and start each history from the pin level (as SEED_HISTORY
+	// does in the C library) so a button held at power on is down straight away, with no press on the way
+	void start()
+	{
+		setup_pins<0>();
+		Io::settle();
+#ifdef __AVR__
+		uint8_t sreg = SREG;  // the tick may already be running
+		cli();
+#endif
+		seed_pins<0>();
+		divider = samplePeriod;
+#ifdef __AVR__
+		SREG = sreg;
+#endif
+	}
+
+	// call every 1ms, eg from the timer ISR - samples the buttons every samplePeriod calls
+	void tick()
+	{
+		if (--divider == 0)
+		{
+			divider = samplePeriod;
+			sample();
+		}
+	}
+
+	// shift the latest level of every pin into its history
+	void sample() { sample_pins<0>(); }
+
+	// The queries read the history as volatile, as the tick writes it from the ISR
+	bool pressed(uint8_t button) const { return history_is_pressed(get(button)); }
+	bool released(uint8_t button) const { return history_is_released(get(button)); }
+	bool down(uint8_t button) const { return history_is_down(get(button)); }
+	bool up(uint8_t button) const { return history_is_up(get(button)); }
+
+	// every state of the button in one go - the HISTORY_ bits from history_lut.h, as button_class() gives
+	uint8_t button_class(uint8_t button) const
+	{
+		uint8_t h = get(button);
+		return HISTORY_CLASSIFY(h, PRESSED_MASK, PRESSED_PATTERN, RELEASED_MASK, RELEASED_PATTERN);
+	}
+
+	uint8_t history(uint8_t button) const { return get(button); }
+
+private:
+	uint8_t get(uint8_t button) const { return *(const volatile uint8_t *)&histories[button]; }
+
+	// The pins are walked by recursion over a constant index rather than a loop, so each pin's address and bit
+	// are constants in the code and the pins[] table is never needed at run time
+	template <uint8_t I>
+	void setup_pins()
+	{
+		if constexpr (I < count)
+		{
+			constexpr ButtonPin pin = Config::pins[I];
+			Io::clear_bit(pin.ddr, pin.terminal);
+			// the same rule as debounce_pull_up(), which can't be constexpr as it is C
+			if constexpr (!(pin.mode & (BUTTON_ACTIVE_HIGH | BUTTON_NO_PULL))) Io::set_bit(pin.outputPort, pin.terminal);
+			else Io::clear_bit(pin.outputPort, pin.terminal);
+			setup_pins<I + 1>();
+		}
+	}
+
+	template <uint8_t I>
+	void seed_pins()
+	{
+		if constexpr (I < count)
+		{
+			constexpr ButtonPin pin = Config::pins[I];
+			histories[I] = debounce_read_polarity(Io::read(pin.inputPort), debounce_polarity(pin.mode), pin.terminal) ? 0xFF : 0x00;
+			seed_pins<I + 1>();
+		}
+	}
+
+	template <uint8_t I>
+	void sample_pins()
+	{
+		if constexpr (I < count)
+		{
+			constexpr ButtonPin pin = Config::pins[I];
+			histories[I] = debounce_shift(histories[I], debounce_read_polarity(Io::read(pin.inputPort), debounce_polarity(pin.mode), pin.terminal));
+			sample_pins<I + 1>();
+		}
+	}
+
+	uint8_t histories[count] = {};
+	uint8_t divider = samplePeriod;
+};
+
+} // namespace debounce
+
+#endif //BUTTON_BANK_HPP
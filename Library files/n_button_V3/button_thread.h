@@ -0,0 +1,115 @@
+/*************************************************************************************************************
+ * button_thread.h - wait for buttons in the main loop without writing a state machine
+ *
+ * Created: 19/10/2026
+ * Author : agent
+ *
+ * Header only - needs BUTTON_EVENTS set to 1 in n_button_debounce_v3.h.  A button thread is a function that
+ * can stop part way through to wait for a button, and carry on from the same place the next time it is
+ * called - a "protothread".  It has no stack of its own, so waiting for "press A, then B within 500ms" reads
+ * like ordinary code and each thread only costs a ButtonThread (5 bytes).  There is no heap.
+ *
+ *   BUTTON_THREAD(unlock_sequence)
+ *   {
+ *       THREAD_BEGIN();
+ *       while (1)
+ *       {
+ *           AWAIT_PRESS(0);                 // wait as long as it takes for button 0
+ *           AWAIT_PRESS_WITHIN(1, 500);     // then button 1, but only for 500ms
+ *           if (!TIMED_OUT()) unlock();
+ *       }
+ *       THREAD_END();
+ *   }
+ *
+ *   ButtonThread unlocker = {0};
+ *   ...
+ *   while (1)
+ *   {
+ *       ButtonEvent e;
+ *       const ButtonEvent *event = get_button_event(&e) ? &e : NULL;
+ *       unlock_sequence(&unlocker, event);    // every thread gets every event, and NULL when there isn't one
+ *       other_thread(&other, event);
+ *   }
+ *
+ * An event a thread has waited for is used up in that thread, so two AWAITs in a row need two events.  As
+ * the thread returns while it waits, local variables are lost across an AWAIT - make them static - and a
+ * switch statement can't have an AWAIT inside it, as the threads are built on one.
+ *
+ ************************************************************************************************************/
+#ifndef BUTTON_THREAD_H
+#define BUTTON_THREAD_H
+
+#include <stdint.h>
+#include <util/atomic.h>
+#include "n_button_debounce_v3.h"
+
+#if !BUTTON_EVENTS
+#error "button threads need BUTTON_EVENTS set to 1"
+#endif
+
+//defines
+#define THREAD_WAITING 0  // what a thread returns while it is waiting
+#define THREAD_ENDED 1    // and once it has got to THREAD_END()
+
+typedef struct
+{
+	uint16_t line;       // where to carry on from, 0 to start at the top
+	uint16_t start;      // ms when the current wait started
+	uint8_t timedOut;    // 1 if the last wait ran out of time
+} ButtonThread;
+
+// the bottom 16 bits of milliCtr, read in one go
+static inline uint16_t button_thread_now(void)
+{
+	uint16_t now;
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		now = (uint16_t)milliCtr;
+	}
+	return now;
+}
+
+#define BUTTON_THREAD(name) uint8_t name(ButtonThread *pt, const ButtonEvent *ev)
+
+#define THREAD_BEGIN() switch (pt->line) { case 0:
+#define THREAD_END() } pt->line = 0; return THREAD_ENDED
+
+// Wait for an event of eventType from whichButton, or timeout ms (0 waits for ever).  Afterwards TIMED_OUT() says which.
+#define AWAIT_EVENT(whichButton, eventType, timeout) \
+	do { \
+		pt->start = button_thread_now(); \
+		pt->timedOut = 0; \
+		pt->line = __LINE__; case __LINE__: \
+		if (ev && (ev->button == (whichButton)) && (ev->type == (eventType))) \
+		{ \
+			ev = 0; \
+			break; \
+		} \
+		if ((timeout) && ((uint16_t)(button_thread_now() - pt->start) >= (uint16_t)(timeout))) \
+		{ \
+			pt->timedOut = 1; \
+			break; \
+		} \
+		return THREAD_WAITING; \
+	} while (0)
+
+#define AWAIT_PRESS(button) AWAIT_EVENT(button, BUTTON_PRESSED, 0)
+#define AWAIT_PRESS_WITHIN(button, timeout) AWAIT_EVENT(button, BUTTON_PRESSED, timeout)
+#define AWAIT_RELEASE(button, timeout) AWAIT_EVENT(button, BUTTON_RELEASED, timeout)
+#define TIMED_OUT() (pt->timedOut)
+
+// wait until cond is true
+#define AWAIT_UNTIL(cond) \
+	do { \
+		pt->line = __LINE__; case __LINE__: \
+		if (!(cond)) return THREAD_WAITING; \
+	} while (0)
+
+// do nothing for ms
+#define THREAD_SLEEP(ms) \
+	do { \
+		pt->start = button_thread_now(); \
+		AWAIT_UNTIL((uint16_t)(button_thread_now() - pt->start) >= (uint16_t)(ms)); \
+	} while (0)
+
+#endif //BUTTON_THREAD_H
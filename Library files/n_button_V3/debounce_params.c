@@ -0,0 +1,84 @@
+/*********************************************************************
+ * debounce_params.c - tuned debounce parameters kept in EEPROM
+ *
+ * Created: 19/10/2026
+ * Author : agent
+ *
+ * See debounce_params.h for how to use it.
+ *
+ **********************************************************************/
+
+//includes
+#include <avr/eeprom.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <util/crc16.h>
+#include "n_button_debounce_v3.h"
+#include "debounce_params.h"
+
+#if !DEBOUNCE_PARAMS
+#error "debounce_params.c needs DEBOUNCE_PARAMS set to 1"
+#endif
+
+DebounceParams debounceParams;
+static DebounceParams EEMEM eeParams;
+
+
+static uint16_t params_crc(const DebounceParams *params)
+{
+	const uint8_t *p = (const uint8_t *)params;
+	uint16_t crc = 0xFFFF;
+	for (uint8_t i = 0; i < offsetof(DebounceParams, crc); i++) crc = _crc16_update(crc, p[i]);
+	return crc;
+}
+
+
+// back to the values the banks are built with
+void default_debounce_params(void)
+{
+	for (uint8_t i = 0; i < DEBOUNCE_PARAM_BANKS; i++) debounceParams.samplePeriod[i] = 0;
+	for (uint8_t i = 0; i < DEBOUNCE_PARAM_PRIORITIES; i++) debounceParams.priorityLockout[i] = 0;
+	debounceParams.version = DEBOUNCE_PARAMS_VERSION;
+	debounceParams.size = sizeof(DebounceParams);
+	debounceParams.crc = params_crc(&debounceParams);
+}
+
+
+// read the block from EEPROM - returns 1 if it was good, 0 if the defaults are being used instead
+uint8_t load_debounce_params(void)
+{
+	eeprom_read_block(&debounceParams, &eeParams, sizeof(DebounceParams));
+	if ((debounceParams.version == DEBOUNCE_PARAMS_VERSION) && (debounceParams.size == sizeof(DebounceParams)) &&
+		(debounceParams.crc == params_crc(&debounceParams)))
+	{
+		return 1;
+	}
+	default_debounce_params();
+	return 0;
+}
+
+
+// write the working copy to EEPROM - only the bytes that differ are written
+void save_debounce_params(void)
+{
+	debounceParams.version = DEBOUNCE_PARAMS_VERSION;
+	debounceParams.size = sizeof(DebounceParams);
+	debounceParams.crc = params_crc(&debounceParams);
+	eeprom_update_block(&debounceParams, &eeParams, sizeof(DebounceParams));
+}
+
+
+// the sample period for the bank in slot, or fallback if there isn't a tuned one
+uint8_t param_sample_period(uint8_t slot, uint8_t fallback)
+{
+	if ((slot < DEBOUNCE_PARAM_BANKS) && debounceParams.samplePeriod[slot]) return debounceParams.samplePeriod[slot];
+	return fallback;
+}
+
+
+// the lockout for the priority input in slot, or fallback if there isn't a tuned one
+uint8_t param_priority_lockout(uint8_t slot, uint8_t fallback)
+{
+	if ((slot < DEBOUNCE_PARAM_PRIORITIES) && debounceParams.priorityLockout[slot]) return debounceParams.priorityLockout[slot];
+	return fallback;
+}
@@ -0,0 +1,60 @@
+/*************************************************************************************************************
+ * debounce_params.h - tuned debounce parameters kept in EEPROM
+ *
+ * Created: 19/10/2026
+ * Author : agent
+ *
+ * Set DEBOUNCE_PARAMS to 1 in n_button_debounce_v3.h (or the compiler symbols) and add debounce_params.c to
+ * the project.  start_debounce() reads the whole block from EEPROM in one go and checks its version, size and
+ * CRC.  If any of them is wrong (a blank chip, a different build, a write cut short by a reset) the defaults
+ * are used instead - the sample periods in each bank's DebounceBankConfig and the lockouts in each priority
+ * input's PriorityConfig.
+ *
+ * The banks are numbered in the order they are added, defaultBank being 0.  Tune them in the field with
+ * set_bank_sample_period(), and the priority inputs (numbered the same way, in the order add_priority_input()
+ * is called) with set_priority_lockout(), then save_debounce_params() to keep the values.  Saving only writes the bytes
+ * that changed (eeprom_update_block), so saving the same values again costs no EEPROM wear, but each byte
+ * that does change takes about 3.4ms - don't save from the ISR.
+ *
+ * Only values that are tuned in the field are kept here - the sample periods and the priority lockouts.  How the
+ * inputs are wired (the pins, and the BUTTON_MODES polarity and pull up) is left out on purpose: it is fixed by
+ * the board, and a stale block from another board could otherwise turn an input's polarity round and have a
+ * stop button read as pressed.
+ *
+ * Add new fields before crc and bump DEBOUNCE_PARAMS_VERSION, and old blocks are ignored rather than misread.
+ * Version 2 added the priority input lockouts.
+ *
+ ************************************************************************************************************/
+#ifndef DEBOUNCE_PARAMS_H
+#define DEBOUNCE_PARAMS_H
+
+#include <stdint.h>
+
+//defines
+#define DEBOUNCE_PARAMS_VERSION 2
+#ifndef DEBOUNCE_PARAM_BANKS
+#define DEBOUNCE_PARAM_BANKS 4  // banks that can have tuned values
+#endif
+#ifndef DEBOUNCE_PARAM_PRIORITIES
+#define DEBOUNCE_PARAM_PRIORITIES 2  // priority inputs that can have tuned lockouts
+#endif
+
+typedef struct
+{
+	uint8_t version;                              // DEBOUNCE_PARAMS_VERSION
+	uint8_t size;                                 // sizeof(DebounceParams)
+	uint8_t samplePeriod[DEBOUNCE_PARAM_BANKS];   // ms, 0 to use the bank's config
+	uint8_t priorityLockout[DEBOUNCE_PARAM_PRIORITIES];  // ms, 0 to use the input's config
+	uint16_t crc;                                 // CRC16 of everything before it
+} DebounceParams;
+
+extern DebounceParams debounceParams;  // the working copy in RAM
+
+//prototype functions
+uint8_t load_debounce_params(void);
+void save_debounce_params(void);
+void default_debounce_params(void);
+uint8_t param_sample_period(uint8_t slot, uint8_t fallback);
+uint8_t param_priority_lockout(uint8_t slot, uint8_t fallback);
+
+#endif //DEBOUNCE_PARAMS_H
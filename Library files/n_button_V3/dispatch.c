@@ -0,0 +1,79 @@
+/*********************************************************************
+ * dispatch.c - calls a handler function for each button event
+ *
+ * Created: 19/10/2026
+ * Author : agent
+ *
+ * See dispatch.h for how to use it.  Everything here runs in the main loop.
+ *
+ **********************************************************************/
+
+//includes
+#include <avr/pgmspace.h>
+#include <stdint.h>
+#include "n_button_debounce_v3.h"
+#include "dispatch.h"
+
+#if !BUTTON_EVENTS
+#error "dispatch.c needs BUTTON_EVENTS set to 1"
+#endif
+
+static ButtonBinding bindings[DISPATCH_BINDINGS];  // bound with bind_button_handler()
+static uint8_t bindingCount;
+static const ButtonBinding *flashTable;             // set_button_handler_table(), in flash
+static uint8_t flashCount;
+
+
+static void dispatch_event(const ButtonBinding *binding, const ButtonEvent *event)
+{
+	if (((binding->button == ANY_BUTTON) || (binding->button == event->button)) &&
+		((binding->type == event->type) ||
+		 ((binding->type == ANY_EVENT) && ((event->type == BUTTON_PRESSED) || (event->type == BUTTON_RELEASED)))))
+	{
+		binding->handler(event);
+	}
+}
+
+
+// add a handler to the RAM table - returns 0 if the table is full (make DISPATCH_BINDINGS bigger)
+uint8_t bind_button_handler(uint8_t button, uint8_t type, ButtonHandler handler)
+{
+	if (bindingCount >= DISPATCH_BINDINGS) return 0;
+	bindings[bindingCount].button = button;
+	bindings[bindingCount].type = type;
+	bindings[bindingCount].handler = handler;
+	bindingCount++;
+	return 1;
+}
+
+
+// use a const table of bindings kept in flash (declare it PROGMEM).  Its handlers are called before the ones
+// bound with bind_button_handler()
+void set_button_handler_table(const ButtonBinding *table, uint8_t count)
+{
+	flashTable = table;
+	flashCount = count;
+}
+
+
+// take all the waiting events and call their handlers - returns the number of events taken
+uint8_t debounce_dispatch(void)
+{
+	ButtonEvent batch[EVENT_QUEUE_SIZE - 1];  // the most the queue can hold
+	uint8_t count = get_button_events(batch, EVENT_QUEUE_SIZE - 1);
+	
+	for (uint8_t e = 0; e < count; e++)
+	{
+		for (uint8_t i = 0; i < flashCount; i++)
+		{
+			ButtonBinding binding;
+			memcpy_P(&binding, &flashTable[i], sizeof(binding));
+			dispatch_event(&binding, &batch[e]);
+		}
+		for (uint8_t i = 0; i < bindingCount; i++)
+		{
+			dispatch_event(&bindings[i], &batch[e]);
+		}
+	}
+	return count;
+}
@@ -0,0 +1,53 @@
+/*************************************************************************************************************
+ * dispatch.h - calls a handler function for each button event, instead of an if block per button
+ *
+ * Created: 19/10/2026
+ * Author : agent
+ *
+ * Needs BUTTON_EVENTS set to 1 in n_button_debounce_v3.h.  Bind a handler to a button and event type, then
+ * call debounce_dispatch() from the main loop.  Each call takes every event waiting in the queue in one batch
+ * and calls the handlers bound to it - it never waits, so call it as often or as seldom as you like (as long
+ * as the queue doesn't fill up, see get_button_event_drops()).  Nothing is allocated: the bindings are either
+ * a fixed table in RAM filled by bind_button_handler(), or a const table in flash, or both.
+ *
+ *   static void start_pump(const ButtonEvent *event) {...}
+ *   static void any_release(const ButtonEvent *event) {...}
+ *
+ *   const ButtonBinding handlers[] PROGMEM =
+ *   {
+ *       {0, BUTTON_PRESSED, start_pump},
+ *       {ANY_BUTTON, BUTTON_RELEASED, any_release},
+ *   };
+ *   ...
+ *   set_button_handler_table(handlers, sizeof(handlers) / sizeof(handlers[0]));
+ *   while (1) debounce_dispatch();
+ *
+ ************************************************************************************************************/
+#ifndef DISPATCH_H
+#define DISPATCH_H
+
+#include <stdint.h>
+#include "n_button_debounce_v3.h"
+
+//defines
+#ifndef DISPATCH_BINDINGS
+#define DISPATCH_BINDINGS 8  // room in the RAM table for bind_button_handler()
+#endif
+#define ANY_BUTTON 0xFF      // binds to every button
+#define ANY_EVENT 0          // binds to both BUTTON_PRESSED and BUTTON_RELEASED - bind chords by their own type
+
+typedef void (*ButtonHandler)(const ButtonEvent *event);
+
+typedef struct
+{
+	uint8_t button;          // the event's button number, or ANY_BUTTON
+	uint8_t type;            // BUTTON_PRESSED, BUTTON_RELEASED, ANY_EVENT, or BUTTON_CHORD/BUTTON_CHORD_END
+	ButtonHandler handler;
+} ButtonBinding;
+
+//prototype functions
+uint8_t bind_button_handler(uint8_t button, uint8_t type, ButtonHandler handler);
+void set_button_handler_table(const ButtonBinding *table, uint8_t count);
+uint8_t debounce_dispatch(void);
+
+#endif //DISPATCH_H
@@ -0,0 +1,152 @@
+/*********************************************************************
+ * encoder.c - quadrature rotary encoders, sampled by the same 1ms tick as the buttons
+ *
+ * Created: 19/10/2026
+ * Author : agent
+ *
+ * See encoder.h for how to use it.  sample_encoders() runs in the timer ISR, everything else in the main loop.
+ *
+ **********************************************************************/
+
+//includes
+#include <avr/io.h>
+#include <avr/pgmspace.h>
+#include <stdint.h>
+#include <util/atomic.h>
+#include "BitManipulation.h"
+#include "n_button_debounce_v3.h"
+#include "encoder.h"
+
+#if !ENCODERS
+#error "encoder.c needs ENCODERS set to 1"
+#endif
+
+// Indexed by old state << 2 | new state, where a state is B<<1 | A.  The gray code order is 00 01 11 10, so
+// moving one place along it is +1, one place back is -1, staying put is 0, and jumping two places (both pins
+// changed between samples) is impossible to decode and marked ERR.
+#define ERR 2
+static const int8_t quadTable[16] PROGMEM =
+{
+	 0, +1, -1, ERR,   // from 00
+	-1,  0, ERR, +1,   // from 01
+	+1, ERR,  0, -1,   // from 10
+	ERR, -1, +1,  0    // from 11
+};
+
+static Encoder *volatile firstEncoder;
+
+
+static uint8_t encoder_read(const EncoderConfig *config)
+{
+	uint8_t pins = ~*config->inputPort;  // active low, like the buttons
+	return (((pins >> config->pinB) & 0x01) << 1) | ((pins >> config->pinA) & 0x01);
+}
+
+
+// the half way point between detents - moving at least this far before coming to rest counts as a step
+static uint8_t encoder_at_detent(const EncoderConfig *config, uint8_t state)
+{
+	switch (config->stepsPerDetent)
+	{
+		case 4:  return state == config->detentState;
+		case 2:  return (state == 0b00) || (state == 0b11);
+		default: return 1;
+	}
+}
+
+
+void sample_encoders(void)
+{
+	for (Encoder *enc = firstEncoder; enc; enc = enc->next)
+	{
+		const EncoderConfig *config = enc->config;
+		uint8_t state = encoder_read(config);
+		int8_t move = (int8_t)pgm_read_byte(&quadTable[(enc->state << 2) | state]);
+		
+		if (move == ERR)
+		{
+			if (enc->errors < UINT16_MAX) enc->errors++;
+		} else if (move)
+		{
+			enc->quarter += move;
+			if (encoder_at_detent(config, state))
+			{
+				int8_t half = (config->stepsPerDetent + 1) / 2;
+				if (enc->quarter >= half) enc->count++;
+				else if (enc->quarter <= -half) enc->count--;
+				enc->quarter = 0;  // lined up with the click again
+			}
+		}
+		enc->state = state;
+		
+		if (++enc->windowMs >= ENCODER_VELOCITY_MS)
+		{
+			enc->velocity = (enc->count - enc->windowStart) * (1000 / ENCODER_VELOCITY_MS);
+			enc->windowStart = enc->count;
+			enc->windowMs = 0;
+		}
+	}
+}
+
+
+// set the encoder's pins up and have the timer tick start sampling it
+void add_encoder(Encoder *enc)
+{
+	const EncoderConfig *config = enc->config;
+	
+	CLEAR_BIT(*config->ddr, config->pinA);  // inputs
+	CLEAR_BIT(*config->ddr, config->pinB);
+	SET_BIT(*config->outputPort, config->pinA);  // pull ups on
+	SET_BIT(*config->outputPort, config->pinB);
+	enc->state = encoder_read(config);
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		enc->next = firstEncoder;
+		firstEncoder = enc;
+	}
+}
+
+
+// detent steps since add_encoder(), clockwise positive (depending on which way round A and B are wired)
+int16_t get_encoder_count(Encoder *enc)
+{
+	int16_t count;
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		count = enc->count;
+	}
+	return count;
+}
+
+
+// detent steps since the last call
+int16_t take_encoder_steps(Encoder *enc)
+{
+	int16_t count = get_encoder_count(enc);
+	int16_t steps = count - enc->taken;
+	enc->taken = count;
+	return steps;
+}
+
+
+// detent steps per second over the last ENCODER_VELOCITY_MS
+int16_t get_encoder_velocity(Encoder *enc)
+{
+	int16_t velocity;
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		velocity = enc->velocity;
+	}
+	return velocity;
+}
+
+
+uint16_t get_encoder_errors(Encoder *enc)
+{
+	uint16_t errors;
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		errors = enc->errors;
+	}
+	return errors;
+}
@@ -0,0 +1,70 @@
+/*************************************************************************************************************
+ * encoder.h - quadrature rotary encoders, sampled by the same 1ms tick as the buttons
+ *
+ * Created: 19/10/2026
+ * Author : agent
+ *
+ * Set ENCODERS to 1 in n_button_debounce_v3.h (or the compiler symbols) and add encoder.c to the project.
+ * Both encoder pins must be on the same port so one read gets them together.  Each tick the two pins are looked
+ * up in a 16 entry transition table - a move to the next state counts +1 or -1 quarter step, a state skipped
+ * (both pins changed at once) is a glitch and is counted as an error instead.  Contact bounce on one pin just
+ * steps back and forth and cancels out.  The quarter steps are turned into detent steps when the encoder
+ * comes to rest in a detent, so the count stays lined up with the clicks even after a glitch.
+ *
+ * Sampled every 1ms the decoder keeps up with 1000 quarter steps a second - about 10 turns a second for a
+ * 24 detent encoder with a full cycle per detent.
+ *
+ * The pins are read active low like the buttons, so a state bit is 1 when its contact is closed (pin pulled to
+ * 0V).  The usual 4 steps per detent encoder (eg the EC11) rests in a click with both contacts open - both pins
+ * high - which reads as 0b00.  Use 0b11 only for the kind that rests with both contacts closed.
+ *
+ *   const EncoderConfig knobConfig = {&PINC, &PORTC, &DDRC, 2, 3, 4, 0b00};  // A on PC2, B on PC3
+ *   Encoder knob = {.config = &knobConfig};
+ *   ...
+ *   start_debounce();
+ *   add_encoder(&knob);
+ *   volume += take_encoder_steps(&knob);
+ *
+ ************************************************************************************************************/
+#ifndef ENCODER_H
+#define ENCODER_H
+
+#include <stdint.h>
+
+//defines
+#define ENCODER_VELOCITY_MS 100  // how often the velocity is worked out, in ms
+
+typedef struct
+{
+	volatile uint8_t *inputPort;   // the PIN register both pins are on
+	volatile uint8_t *outputPort;  // the PORT register, for the pull ups
+	volatile uint8_t *ddr;
+	uint8_t pinA;
+	uint8_t pinB;
+	uint8_t stepsPerDetent;        // quarter steps between clicks - 4, 2 or 1
+	uint8_t detentState;           // B<<1 | A when resting in a click, 1 = contact closed (for 4 steps per detent, usually 0b00)
+} EncoderConfig;
+
+typedef struct Encoder
+{
+	const EncoderConfig *config;
+	uint8_t state;           // B<<1 | A at the last sample
+	int8_t quarter;          // quarter steps since the last detent
+	int16_t count;           // detent steps since add_encoder() - read it with get_encoder_count()
+	int16_t taken;           // count when take_encoder_steps() was last called
+	int16_t windowStart;     // count at the start of the velocity window
+	uint8_t windowMs;
+	int16_t velocity;        // detent steps per second over the last window
+	uint16_t errors;         // skipped states seen (stops at 0xFFFF)
+	struct Encoder *next;    // the next encoder the tick samples
+} Encoder;
+
+//prototype functions
+void add_encoder(Encoder *enc);
+int16_t get_encoder_count(Encoder *enc);
+int16_t take_encoder_steps(Encoder *enc);
+int16_t get_encoder_velocity(Encoder *enc);
+uint16_t get_encoder_errors(Encoder *enc);
+void sample_encoders(void);  // called by the timer ISR
+
+#endif //ENCODER_H
@@ -0,0 +1,192 @@
+/*********************************************************************
+ * flight_recorder.c - the last raw samples of a bank, run length encoded, frozen on a ghost press
+ *
+ * Created: 19/10/2026
+ * Author : agent
+ *
+ * See flight_recorder.h for how to use it.  flight_record() runs in the timer ISR after each bank is sampled,
+ * everything else in the main loop.
+ *
+ **********************************************************************/
+
+//includes
+#include <avr/io.h>
+#include <avr/pgmspace.h>
+#include <stdint.h>
+#include <util/atomic.h>
+#include "n_button_debounce_v3.h"
+#include "flight_recorder.h"
+
+#if !FLIGHT_RECORDER
+#error "flight_recorder.c needs FLIGHT_RECORDER set to 1"
+#endif
+#if FLIGHT_RECORDER_RUNS > 255
+#error "FLIGHT_RECORDER_RUNS can be 255 at most"
+#endif
+
+static const DebounceBank *volatile recBank;  // the bank being recorded
+static FlightRun runs[FLIGHT_RECORDER_RUNS];   // a ring, runs[recHead] is the latest
+static uint8_t recHead;
+static uint8_t recUsed;                        // runs in the ring so far
+static volatile uint8_t recState;
+static uint8_t recReason;
+static uint8_t recAfter;                       // samples recorded since the trigger
+#if FLIGHT_GHOST_MS
+static ButtonMask recDown;                     // the debounced state, decided the same way as the events
+static uint8_t pressAge[MAX_BANK_BUTTONS];     // samples since each button's press, stops at 255
+#endif
+
+
+static void flight_trigger(uint8_t reason)
+{
+	if (recState != FLIGHT_RECORDING) return;  // the first trigger is the one that counts
+	recReason = reason;
+	recAfter = 0;
+	recState = FLIGHT_TRIGGERED;
+}
+
+
+void flight_record(const DebounceBank *bank)
+{
+	if ((bank != recBank) || (recState == FLIGHT_FROZEN)) return;
+
+	const DebounceBankConfig *config = bank->config;
+	const uint8_t *history = bank->history;
+	ButtonMask sample = 0;
+
+	// the latest raw sample of each button is bit 0 of its history
+	for (uint8_t i = config->count; i--; )
+	{
+		sample = (sample << 1) | (history[i] & 0x01);
+	}
+
+	FlightRun *run = &runs[recHead];
+	if (recUsed && (run->sample == sample) && (run->count < UINT8_MAX))
+	{
+		run->count++;
+	} else
+	{
+		recHead = (recHead + 1) % FLIGHT_RECORDER_RUNS;
+		runs[recHead].sample = sample;
+		runs[recHead].count = 1;
+		if (recUsed < FLIGHT_RECORDER_RUNS) recUsed++;  // once full the oldest run is written over
+	}
+
+#if FLIGHT_GHOST_MS
+	ButtonMask bit = 1;
+	for (uint8_t i = 0; i < config->count; i++, bit <<= 1)
+	{
+		uint8_t cls = pgm_read_byte(&config->classTable[history[i]]);
+		if (!(recDown & bit))
+		{
+			if (cls & (HISTORY_PRESSED | HISTORY_DOWN))
+			{
+				recDown |= bit;
+				pressAge[i] = 0;
+			}
+		} else
+		{
+			if (pressAge[i] < UINT8_MAX) pressAge[i]++;
+			if (cls & (HISTORY_RELEASED | HISTORY_UP))
+			{
+				recDown &= ~bit;
+				if ((uint16_t)pressAge[i] * bank->samplePeriod < FLIGHT_GHOST_MS) flight_trigger(FLIGHT_GHOST);
+			}
+		}
+	}
+#endif
+
+	if ((recState == FLIGHT_TRIGGERED) && (++recAfter >= FLIGHT_AFTER_SAMPLES)) recState = FLIGHT_FROZEN;
+}
+
+
+// record bank from now on, with an empty ring
+void start_flight_recorder(DebounceBank *bank)
+{
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		recBank = bank;
+		recHead = FLIGHT_RECORDER_RUNS - 1;  // so the first run goes in runs[0]
+		recUsed = 0;
+		recReason = 0;
+		recAfter = 0;
+		recState = FLIGHT_RECORDING;
+#if FLIGHT_GHOST_MS
+		// start from the debounced state the bank has now, so a button already held isn't taken as a new press
+		recDown = 0;
+		for (uint8_t i = 0; i < bank->config->count; i++)
+		{
+			if (bank->history[i] == 0xFF) recDown |= (ButtonMask)1 << i;
+			pressAge[i] = UINT8_MAX;
+		}
+#endif
+	}
+}
+
+
+// empty the ring and record again, eg after the dump has been sent
+void restart_flight_recorder(void)
+{
+	if (recBank) start_flight_recorder((DebounceBank *)recBank);
+}
+
+
+// trigger by hand - the recorder freezes after FLIGHT_AFTER_SAMPLES more samples
+void freeze_flight_recorder(void)
+{
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		flight_trigger(FLIGHT_REQUESTED);
+	}
+}
+
+
+uint8_t flight_recorder_state(void)
+{
+	return recState;
+}
+
+
+// Write the recording into dump in the format in flight_recorder.h and return its length, or 0 if size is too
+// small (FLIGHT_DUMP_MAX is always enough).  It can be called while still recording, interrupts are turned off
+// for the copy.
+uint16_t dump_flight_recorder(uint8_t *dump, uint16_t size)
+{
+	uint16_t length = 0;
+
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		const DebounceBank *bank = recBank;
+		uint16_t needed = FLIGHT_HEADER_SIZE + recUsed * (sizeof(ButtonMask) + 1);
+		if (bank && (size >= needed))
+		{
+			uint8_t *p = dump;
+			*p++ = 'F';
+			*p++ = 'R';
+			*p++ = FLIGHT_VERSION;
+			*p++ = bank->config->count;
+			*p++ = bank->config->firstId;
+			*p++ = bank->samplePeriod;
+			*p++ = (recState == FLIGHT_RECORDING) ? 0 : recReason;
+			*p++ = sizeof(ButtonMask);
+			*p++ = recAfter;
+			*p++ = recUsed & 0xFF;
+			*p++ = 0;  // the high byte - the ring never holds more than 255 runs
+
+			uint8_t index = (recHead + FLIGHT_RECORDER_RUNS + 1 - recUsed) % FLIGHT_RECORDER_RUNS;  // the oldest
+			for (uint8_t r = 0; r < recUsed; r++)
+			{
+				ButtonMask sample = runs[index].sample;
+				for (uint8_t b = 0; b < sizeof(ButtonMask); b++)
+				{
+					*p++ = sample & 0xFF;
+					sample >>= 8;
+				}
+				*p++ = runs[index].count;
+				index = (index + 1) % FLIGHT_RECORDER_RUNS;
+			}
+			length = p - dump;
+		}
+	}
+	return length;
+}
@@ -0,0 +1,86 @@
+/*************************************************************************************************************
+ * flight_recorder.h - keeps the last raw samples of a bank, to find out what caused a "ghost press"
+ *
+ * Created: 19/10/2026
+ * Author : agent
+ *
+ * Set FLIGHT_RECORDER to 1 in n_button_debounce_v3.h (or the compiler symbols) and add flight_recorder.c to the
+ * project.  Every time its bank is sampled the recorder keeps the raw sample of every button - one bit each,
+ * before any debouncing - in a small ring buffer of runs: a sample the same as the last one just adds 1 to the
+ * run's count, so a quiet panel costs one run per 255 samples (over a second at 5ms) and the buffer holds the
+ * recent activity rather than the recent time.
+ *
+ * The recorder freezes, keeping what it has, on a trigger:
+ *   - a ghost press - a press the debounce let go of again within FLIGHT_GHOST_MS (0 turns this off)
+ *   - freeze_flight_recorder(), eg when the user presses "report fault"
+ * It still records FLIGHT_AFTER_SAMPLES samples after the trigger, to see what followed.
+ *
+ *   start_debounce();
+ *   start_flight_recorder(&defaultBank);
+ *   ...
+ *   if (flight_recorder_state() == FLIGHT_FROZEN)
+ *   {
+ *       uint8_t dump[FLIGHT_DUMP_MAX];
+ *       uint16_t size = dump_flight_recorder(dump, sizeof(dump));
+ *       ... send the size bytes of dump out of the UART, write them to EEPROM etc
+ *       restart_flight_recorder();
+ *   }
+ *
+ * "Host tools/flight_replay.c" replays a dump through the host build of the debounce and prints what the
+ * library decided, sample by sample.  The dump is, with 16 bit numbers low byte first:
+ *   'F' 'R'                magic
+ *   version                FLIGHT_VERSION
+ *   buttons                in the bank
+ *   firstId                the bank's first event number
+ *   samplePeriod           ms
+ *   reason                 FLIGHT_GHOST or FLIGHT_REQUESTED, 0 if it was still running
+ *   maskBytes              bytes per sample - 1, 2 or 4
+ *   after                  samples recorded after the trigger
+ *   runs                   16 bits
+ * then each run, oldest first: the sample (maskBytes, low byte first, bit 0 is the bank's first button and 1 is
+ * pressed) and a one byte count of how many samples in a row it was.
+ *
+ ************************************************************************************************************/
+#ifndef FLIGHT_RECORDER_H
+#define FLIGHT_RECORDER_H
+
+#include <stdint.h>
+#include "n_button_debounce_v3.h"
+
+//defines
+#ifndef FLIGHT_RECORDER_RUNS
+#define FLIGHT_RECORDER_RUNS 64  // runs kept - each is a ButtonMask and a count, ie 2 bytes for up to 8 buttons
+#endif
+#ifndef FLIGHT_GHOST_MS
+#define FLIGHT_GHOST_MS 40       // a press released within this many ms freezes the recorder, 0 for never
+#endif
+#define FLIGHT_AFTER_SAMPLES 32  // samples still recorded after a trigger
+
+#define FLIGHT_VERSION 1
+#define FLIGHT_HEADER_SIZE 11
+#define FLIGHT_DUMP_MAX (FLIGHT_HEADER_SIZE + FLIGHT_RECORDER_RUNS * (sizeof(ButtonMask) + 1))  // biggest dump
+
+//states
+#define FLIGHT_RECORDING 0
+#define FLIGHT_TRIGGERED 1  // recording the samples after the trigger
+#define FLIGHT_FROZEN 2
+
+//trigger reasons
+#define FLIGHT_GHOST 1
+#define FLIGHT_REQUESTED 2
+
+typedef struct
+{
+	ButtonMask sample;  // the raw level of each button, 1 = pressed
+	uint8_t count;      // samples in a row it was seen for, 1 to 255
+} FlightRun;
+
+//prototype functions
+void start_flight_recorder(DebounceBank *bank);
+void restart_flight_recorder(void);
+void freeze_flight_recorder(void);
+uint8_t flight_recorder_state(void);
+uint16_t dump_flight_recorder(uint8_t *dump, uint16_t size);
+void flight_record(const DebounceBank *bank);  // called by the timer ISR
+
+#endif //FLIGHT_RECORDER_H
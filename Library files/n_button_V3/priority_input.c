@@ -0,0 +1,223 @@
+/*********************************************************************
+ * priority_input.c - buttons that react on their first edge, from INT0, INT1 or a pin change interrupt
+ *
+ * Created: 19/10/2026
+ * Author : agent
+ *
+ * See priority_input.h for how to use it.  priority_edge() runs in the pin interrupts and priority_tick() in
+ * the timer ISR.  AVR interrupts don't interrupt each other, so they never run at the same time.
+ *
+ **********************************************************************/
+
+//includes
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <stdint.h>
+#include <util/atomic.h>
+#include "BitManipulation.h"
+#include "n_button_debounce_v3.h"
+#include "n_button_debounce_v3_inline.h"
+#include "priority_input.h"
+#if DEBOUNCE_PARAMS
+#include "debounce_params.h"
+#endif
+
+#if !PRIORITY_INPUTS
+#error "priority_input.c needs PRIORITY_INPUTS set to 1"
+#endif
+
+static PriorityInput *volatile firstInput;
+static uint8_t inputCount;  // inputs added so far, for their slot numbers
+
+
+// the level of the input, 1 = on, whichever way round it is wired
+static uint8_t priority_read(const PriorityConfig *config)
+{
+#if BUTTON_MODES
+	return debounce_read_polarity(*config->inputPort, debounce_polarity(config->mode), config->terminal);
+#else
+	return read_button(config->inputPort, config->terminal);
+#endif
+}
+
+
+// turn the input's own interrupt on or off.  For a pin change interrupt only its pin's mask bit is touched
+static void priority_enable(const PriorityConfig *config, uint8_t on)
+{
+	switch (config->source)
+	{
+		case PRIORITY_INT0:
+			if (on)
+			{
+				EIFR = (1<<INTF0);  // forget the bounces seen while it was off - the level has been checked
+				SET_BIT(EIMSK, INT0);
+			} else CLEAR_BIT(EIMSK, INT0);
+			break;
+		case PRIORITY_INT1:
+			if (on)
+			{
+				EIFR = (1<<INTF1);
+				SET_BIT(EIMSK, INT1);
+			} else CLEAR_BIT(EIMSK, INT1);
+			break;
+		// the pin change flags are shared by the whole port, so they are left alone - a stale one just
+		// finds no input has changed
+		case PRIORITY_PCINT_B:
+			if (on) SET_BIT(PCMSK0, config->terminal); else CLEAR_BIT(PCMSK0, config->terminal);
+			break;
+		case PRIORITY_PCINT_C:
+			if (on) SET_BIT(PCMSK1, config->terminal); else CLEAR_BIT(PCMSK1, config->terminal);
+			break;
+		case PRIORITY_PCINT_D:
+			if (on) SET_BIT(PCMSK2, config->terminal); else CLEAR_BIT(PCMSK2, config->terminal);
+			break;
+	}
+}
+
+
+// report a change of the input and start its lockout
+static void priority_report(PriorityInput *input, uint8_t down)
+{
+	const PriorityConfig *config = input->config;
+	uint8_t type = down ? BUTTON_PRESSED : BUTTON_RELEASED;
+	
+	input->down = down;
+	input->lockout = input->lockoutMs;
+	priority_enable(config, 0);
+	if (config->handler) config->handler(type);
+#if BUTTON_EVENTS
+	queue_button_event(config->id, type);
+#endif
+}
+
+
+// an edge on source - report every input on it that has changed and isn't locked out
+static void priority_edge(uint8_t source)
+{
+	for (PriorityInput *input = firstInput; input; input = input->next)
+	{
+		const PriorityConfig *config = input->config;
+		if ((config->source != source) || input->lockout) continue;
+		uint8_t down = priority_read(config);
+		if (down != input->down) priority_report(input, down);
+	}
+}
+
+
+#if PRIORITY_SOURCES & PRIORITY_INT0
+ISR(INT0_vect)
+{
+	priority_edge(PRIORITY_INT0);
+}
+#endif
+
+#if PRIORITY_SOURCES & PRIORITY_INT1
+ISR(INT1_vect)
+{
+	priority_edge(PRIORITY_INT1);
+}
+#endif
+
+#if PRIORITY_SOURCES & PRIORITY_PCINT_B
+ISR(PCINT0_vect)
+{
+	priority_edge(PRIORITY_PCINT_B);
+}
+#endif
+
+#if PRIORITY_SOURCES & PRIORITY_PCINT_C
+ISR(PCINT1_vect)
+{
+	priority_edge(PRIORITY_PCINT_C);
+}
+#endif
+
+#if PRIORITY_SOURCES & PRIORITY_PCINT_D
+ISR(PCINT2_vect)
+{
+	priority_edge(PRIORITY_PCINT_D);
+}
+#endif
+
+
+// the lockouts, every 1ms from the timer ISR
+void priority_tick(void)
+{
+	for (PriorityInput *input = firstInput; input; input = input->next)
+	{
+		if (!input->lockout || --input->lockout) continue;
+		
+		const PriorityConfig *config = input->config;
+		uint8_t down = priority_read(config);
+		if (down != input->down) priority_report(input, down);  // it changed while locked out
+		else priority_enable(config, 1);
+	}
+}
+
+
+// set the pin up, take its current level as the starting state and switch its interrupt on.  Returns 0, having
+// done nothing, if the input's interrupt has no ISR in this file
+uint8_t add_priority_input(PriorityInput *input)
+{
+	const PriorityConfig *config = input->config;
+	
+	if (!(config->source & PRIORITY_SOURCES)) return 0;
+	uint8_t lockoutMs = config->lockoutMs;
+	
+	CLEAR_BIT(*config->ddr, config->terminal);  // input
+#if BUTTON_MODES
+	if (debounce_pull_up(config->mode)) SET_BIT(*config->outputPort, config->terminal);
+	else CLEAR_BIT(*config->outputPort, config->terminal);  // pull up off
+#else
+	SET_BIT(*config->outputPort, config->terminal);  // pull up on
+#endif
+	input->slot = inputCount++;
+#if DEBOUNCE_PARAMS
+	lockoutMs = param_priority_lockout(input->slot, lockoutMs);
+#endif
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		input->down = priority_read(config);
+		input->lockout = 0;
+		input->lockoutMs = lockoutMs ? lockoutMs : 1;  // 0 would leave the interrupt off for good
+		input->next = firstInput;
+		firstInput = input;
+		switch (config->source)
+		{
+			case PRIORITY_INT0:
+				EICRA = (EICRA & ~((1<<ISC01) | (1<<ISC00))) | (1<<ISC00);  // any change
+				break;
+			case PRIORITY_INT1:
+				EICRA = (EICRA & ~((1<<ISC11) | (1<<ISC10))) | (1<<ISC10);
+				break;
+			case PRIORITY_PCINT_B:
+				SET_BIT(PCICR, PCIE0);
+				break;
+			case PRIORITY_PCINT_C:
+				SET_BIT(PCICR, PCIE1);
+				break;
+			case PRIORITY_PCINT_D:
+				SET_BIT(PCICR, PCIE2);
+				break;
+		}
+		priority_enable(config, 1);
+	}
+	return 1;
+}
+
+
+uint8_t is_priority_down(PriorityInput *input)
+{
+	return input->down;
+}
+
+
+// change the lockout while running - from the next edge on.  0 is taken as 1
+void set_priority_lockout(PriorityInput *input, uint8_t ms)
+{
+	if (ms == 0) ms = 1;
+	input->lockoutMs = ms;  // one byte, so the ISRs never see half of it
+#if DEBOUNCE_PARAMS
+	if (input->slot < DEBOUNCE_PARAM_PRIORITIES) debounceParams.priorityLockout[input->slot] = ms;
+#endif
+}
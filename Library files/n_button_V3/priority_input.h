@@ -0,0 +1,82 @@
+/*************************************************************************************************************
+ * priority_input.h - buttons that react on their first edge, from INT0, INT1 or a pin change interrupt
+ *
+ * Created: 19/10/2026
+ * Author : agent
+ *
+ * Set PRIORITY_INPUTS to 1 in n_button_debounce_v3.h (or the compiler symbols) and add priority_input.c to
+ * the project.  A priority input isn't debounced before it is reported - the first edge on the pin fires the
+ * hardware interrupt, which calls the input's handler straight away (rather than after the tens of ms the
+ * history needs - the time from the edge hasn't been measured) and queues a BUTTON_PRESSED or BUTTON_RELEASED
+ * event if BUTTON_EVENTS is on.
+ * Then the pin's interrupt is switched off for lockoutMs so the bounces are ignored, and the 1ms tick switches
+ * it back on.  If the pin has changed again by then, the change is reported at once and the lockout starts
+ * again, so a short press is never lost.  A lockoutMs of 0 is taken as 1 - the interrupt always stays off until
+ * the next tick has checked the pin, or an input that bounced straight back would never be switched on again.
+ *
+ * INT0 is PD2 and INT1 is PD3.  Any pin can use its port's pin change interrupt.  Only the interrupts in
+ * PRIORITY_SOURCES are taken over by this file, so the others are still free for your own code.
+ * add_priority_input() returns 0 and sets nothing up for an input whose source isn't in PRIORITY_SOURCES - its
+ * interrupt has no handler here, and switching it on would reset the chip on the first edge.  With
+ * BUTTON_MODES on, PriorityConfig gets a mode at the end, as Buttons does - eg BUTTON_ACTIVE_HIGH for a safety
+ * relay contact that goes high when tripped.
+ *
+ * With DEBOUNCE_PARAMS on, the lockouts of the first DEBOUNCE_PARAM_PRIORITIES inputs (numbered in the order
+ * they are added) can be tuned with set_priority_lockout() and kept in EEPROM with the sample periods.
+ *
+ *   static void stop_now(uint8_t type) { if (type == BUTTON_PRESSED) motor_off(); }   // runs in the interrupt
+ *   const PriorityConfig estopConfig = {&PIND, &PORTD, &DDRD, 2, PRIORITY_INT0, 20, 30, stop_now};
+ *   PriorityInput estop = {.config = &estopConfig};
+ *   ...
+ *   start_debounce();
+ *   if (!add_priority_input(&estop)) ...   // PRIORITY_INT0 isn't in PRIORITY_SOURCES
+ *
+ ************************************************************************************************************/
+#ifndef PRIORITY_INPUT_H
+#define PRIORITY_INPUT_H
+
+#include <stdint.h>
+#include "n_button_debounce_v3.h"
+
+//defines - the interrupt a priority input uses, also the bits of PRIORITY_SOURCES
+#define PRIORITY_INT0    0x01   // PD2
+#define PRIORITY_INT1    0x02   // PD3
+#define PRIORITY_PCINT_B 0x04   // any pin of port B
+#define PRIORITY_PCINT_C 0x08   // any pin of port C
+#define PRIORITY_PCINT_D 0x10   // any pin of port D
+#ifndef PRIORITY_SOURCES
+#define PRIORITY_SOURCES (PRIORITY_INT0 | PRIORITY_INT1)  // the interrupt vectors priority_input.c defines
+#endif
+
+typedef struct
+{
+	volatile uint8_t *inputPort;
+	volatile uint8_t *outputPort;  // for the pull up
+	volatile uint8_t *ddr;
+	uint8_t terminal;
+	uint8_t source;                // PRIORITY_INT0 etc
+	uint8_t lockoutMs;             // how long to ignore the pin after an edge
+	uint8_t id;                    // the button number its events carry
+	void (*handler)(uint8_t type); // called in the interrupt with BUTTON_PRESSED or BUTTON_RELEASED, or NULL
+#if BUTTON_MODES
+	uint8_t mode;                  // BUTTON_ACTIVE_HIGH and/or BUTTON_NO_PULL, 0 for active low with the pull up
+#endif
+} PriorityConfig;
+
+typedef struct PriorityInput
+{
+	const PriorityConfig *config;
+	volatile uint8_t down;         // the state last reported, 1 = pressed
+	uint8_t lockout;               // ms left before the pin's interrupt goes back on
+	uint8_t lockoutMs;             // the lockout in use - from the config, or tuned
+	uint8_t slot;                  // the order it was added in, for its tuned lockout
+	struct PriorityInput *next;
+} PriorityInput;
+
+//prototype functions
+uint8_t add_priority_input(PriorityInput *input);  // 1 if added, 0 if its source isn't in PRIORITY_SOURCES
+uint8_t is_priority_down(PriorityInput *input);
+void set_priority_lockout(PriorityInput *input, uint8_t ms);
+void priority_tick(void);  // called by the timer ISR
+
+#endif //PRIORITY_INPUT_H
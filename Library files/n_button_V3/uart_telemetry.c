@@ -0,0 +1,113 @@
+/*********************************************************************
+ * uart_telemetry.c - sends the debounced button events out of the UART
+ *
+ * Created: 19/10/2026
+ * Author : agent
+ *
+ * See uart_telemetry.h for the frame format.  The ring buffer has one writer (uart_telemetry_poll() in the
+ * main loop) and one reader (the UDRE interrupt) and single byte indexes, so neither side turns interrupts off.
+ *
+ **********************************************************************/
+
+//includes
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <stdint.h>
+#include "n_button_debounce_v3.h"
+#include "uart_telemetry.h"
+
+#if !BUTTON_EVENTS
+#error "uart telemetry needs BUTTON_EVENTS set to 1"
+#endif
+
+#define TX_BUFFER_SIZE 64  // must be a power of 2
+#define TX_MASK (TX_BUFFER_SIZE - 1)
+
+static uint8_t txBuffer[TX_BUFFER_SIZE];
+static volatile uint8_t txHead;  // written by the main loop
+static volatile uint8_t txTail;  // written by the ISR
+static uint16_t txDrops;         // frames lost since start
+static uint16_t txUnreported;    // frames lost that no drops frame has told the host about yet
+static uint16_t txRejects;       // events not sent as their button number doesn't fit in a frame
+static uint16_t txLastTime;      // time of the last event frame sent, for the delta
+
+
+//UART data register empty - send the next byte, or turn the interrupt off when there is nothing left
+ISR(USART_UDRE_vect)
+{
+	uint8_t tail = txTail;
+	if (tail == txHead)
+	{
+		UCSR0B &= ~(1<<UDRIE0);
+		return;
+	}
+	UDR0 = txBuffer[tail];
+	txTail = (tail + 1) & TX_MASK;
+}
+
+
+// queue one frame if it fits whole - returns 0 if it didn't
+static uint8_t send_frame(uint8_t type, uint8_t button, uint16_t value)
+{
+	uint8_t head = txHead;
+	uint8_t id = (type << 5) | button;  // the callers keep button to 5 bits
+	
+	if (((txTail - head - 1) & TX_MASK) < TELEMETRY_FRAME_SIZE) return 0;
+	
+	txBuffer[head] = TELEMETRY_SYNC;
+	txBuffer[(head + 1) & TX_MASK] = id;
+	txBuffer[(head + 2) & TX_MASK] = value & 0xFF;
+	txBuffer[(head + 3) & TX_MASK] = value >> 8;
+	txBuffer[(head + 4) & TX_MASK] = id ^ (value & 0xFF) ^ (value >> 8);
+	txHead = (head + TELEMETRY_FRAME_SIZE) & TX_MASK;
+	UCSR0B |= (1<<UDRIE0);  // the ISR only ever clears this bit, so setting it here can't lose anything
+	return 1;
+}
+
+
+void start_uart_telemetry(void)
+{
+	UBRR0 = (F_CPU + 4 * TELEMETRY_BAUD) / (8 * TELEMETRY_BAUD) - 1;  // rounded, for double speed mode
+	UCSR0A = (1<<U2X0);
+	UCSR0C = (1<<UCSZ01) | (1<<UCSZ00);  // 8 data bits, no parity, 1 stop bit
+	UCSR0B = (1<<TXEN0);
+}
+
+
+// move every queued button event into the transmit buffer
+void uart_telemetry_poll(void)
+{
+	ButtonEvent event;
+	
+	while (get_button_event(&event))
+	{
+		if (txUnreported && send_frame(TELEMETRY_DROPS, TELEMETRY_NO_BUTTON, txUnreported)) txUnreported = 0;
+		
+		if ((event.button > TELEMETRY_MAX_BUTTON) || (event.type >= TELEMETRY_DROPS))
+		{
+			if (txRejects < UINT16_MAX) txRejects++;  // it would turn up as the wrong button, or as a drops frame
+			continue;
+		}
+		if (send_frame(event.type, event.button, event.time - txLastTime))
+		{
+			txLastTime = event.time;
+		} else
+		{
+			if (txDrops < UINT16_MAX) txDrops++;
+			if (txUnreported < UINT16_MAX) txUnreported++;
+		}
+	}
+	if (txUnreported && send_frame(TELEMETRY_DROPS, TELEMETRY_NO_BUTTON, txUnreported)) txUnreported = 0;
+}
+
+
+uint16_t get_uart_telemetry_drops(void)
+{
+	return txDrops;
+}
+
+
+uint16_t get_uart_telemetry_rejects(void)
+{
+	return txRejects;
+}
@@ -0,0 +1,45 @@
+/*************************************************************************************************************
+ * uart_telemetry.h - sends the debounced button events out of the UART
+ *
+ * Created: 19/10/2026
+ * Author : agent
+ *
+ * Needs BUTTON_EVENTS set to 1 in n_button_debounce_v3.h.  Call start_uart_telemetry() once after
+ * start_debounce() and uart_telemetry_poll() from the main loop.  Neither of them ever waits for the UART -
+ * the frames go into a ring buffer and the UART data register empty interrupt sends them.  If the buffer is
+ * full the frame is dropped and counted, and a drops frame is sent as soon as there is room again.  An event
+ * whose button number won't fit in the frame (over TELEMETRY_MAX_BUTTON) isn't sent at all, rather than
+ * arriving as some other button - get_uart_telemetry_rejects() counts them.
+ *
+ * Each frame is 5 bytes:
+ *   0xA5                   sync
+ *   type<<5 | button       type is the event type (BUTTON_PRESSED etc) or TELEMETRY_DROPS, button is 0-30
+ *                          (31, TELEMETRY_NO_BUTTON, is kept for the drops frames)
+ *   delta low, delta high  ms since the previous frame sent (for a drops frame, the number of frames lost)
+ *   check                  xor of the 3 bytes before it
+ *
+ * "Host tools/telemetry_decode.c" turns the frames back into text.
+ *
+ ************************************************************************************************************/
+#ifndef UART_TELEMETRY_H
+#define UART_TELEMETRY_H
+
+#include <stdint.h>
+
+//defines
+#ifndef TELEMETRY_BAUD
+#define TELEMETRY_BAUD 38400UL  // 0.2% error at 8MHz with the double speed UART
+#endif
+#define TELEMETRY_SYNC 0xA5
+#define TELEMETRY_DROPS 7       // frame type reporting lost frames
+#define TELEMETRY_NO_BUTTON 31  // the button field of a drops frame, never an event's
+#define TELEMETRY_MAX_BUTTON 30 // the highest button number a frame can carry
+#define TELEMETRY_FRAME_SIZE 5
+
+//prototype functions
+void start_uart_telemetry(void);
+void uart_telemetry_poll(void);
+uint16_t get_uart_telemetry_drops(void);
+uint16_t get_uart_telemetry_rejects(void);
+
+#endif //UART_TELEMETRY_H